@@ -0,0 +1,382 @@
+/* Maximal flow - Boykov-Kolmogorov algorithm */
+/* Y. Boykov, V. Kolmogorov: An experimental comparison of min-cut/max-flow */
+/* algorithms for energy minimization in vision, IEEE PAMI 26(9), 2004 */
+
+#include "BKMaxflow.h"
+#include "Digraph.h"
+
+#include <limits>
+
+#define FREE 0
+#define SOURCE 1
+#define TARGET 2
+// parent of the roots (source and target) and of nodes without a parent
+#define TERMINAL -1
+#define ORPHAN -2
+#define INFINITE_DIST numeric_limits<int>::max()
+#define MIN( a, b ) ( ( ( a ) < ( b ) ) ? ( a ) : ( b ) )
+
+// --- constructors --- //
+template <class Cap>
+BKMaxflowT<Cap>::BKMaxflowT( int n, int m, const pair<u_int, u_int> *arcs ) :
+	n( n ), m( m )
+{
+	build( arcs );
+}
+
+template <class Cap>
+BKMaxflowT<Cap>::BKMaxflowT( const Digraph& digraph ) :
+	n( digraph.n_nodes ), m( digraph.n_arcs )
+{
+	vector<pair<u_int, u_int> > arcs( m );
+	for( int i = 0; i < m; i++ ) {
+		arcs[i] = pair<u_int, u_int>( digraph.arcs[i].v1, digraph.arcs[i].v2 );
+	}
+	build( m > 0 ? &arcs[0] : NULL );
+}
+
+// --- arcs grouped by their origin, each with its opposite arc --- //
+template <class Cap>
+void BKMaxflowT<Cap>::build( const pair<u_int, u_int> *arcs )
+{
+	arc_first.assign( n + 1, 0 );
+	for( int i = 0; i < m; i++ ) {
+		if( arcs[i].first == arcs[i].second ) continue; // omit self-loops
+		arc_first[arcs[i].first + 1]++;
+		arc_first[arcs[i].second + 1]++;
+	}
+	for( int i = 0; i < n; i++ ) {
+		arc_first[i + 1] += arc_first[i];
+	}
+	num_arcs = arc_first[n];
+
+	cap.assign( num_arcs, 0 );
+	r_cap.assign( num_arcs, 0 );
+	head.resize( num_arcs );
+	sister.resize( num_arcs );
+	idx.resize( num_arcs );
+	arc_pos.assign( m, -1 );
+	adj.resize( num_arcs );
+	last.resize( n );
+	vector<int> pos( arc_first.begin(), arc_first.end() - 1 );
+	for( int i = 0; i < m; i++ ) {
+		int v1 = arcs[i].first, v2 = arcs[i].second;
+		if( v1 == v2 ) continue;
+		int a = pos[v1]++, b = pos[v2]++;
+		head[a] = v2;
+		head[b] = v1;
+		sister[a] = b;
+		sister[b] = a;
+		idx[a] = i + 1;
+		idx[b] = -(i + 1);
+		arc_pos[i] = a;
+	}
+
+	tree.assign( n, FREE );
+	parent.assign( n, ORPHAN );
+	next.assign( n, -1 );
+	stamp.assign( n, 0 );
+	dist.assign( n, 0 );
+	nsource = nsink = 0;
+	first_active = last_active = -1;
+	time = 0;
+	flow = 0;
+	relist();
+} // end of build(const pair<u_int, u_int> *arcs)
+
+// --- update capacities and source/target nodes --- //
+template <class Cap>
+void BKMaxflowT<Cap>::update( int s, int t, const Cap *capacities )
+{
+	for( int a = 0; a < num_arcs; a++ ) {
+		r_cap[a] = cap[a] = idx[a] > 0 ? capacities[idx[a] - 1] : 0;
+	}
+	relist();
+	nsource = s;
+	nsink = t;
+	reset();
+} // end of update(int s, int t, const Cap *capacities)
+
+// --- update source/target nodes --- //
+template <class Cap>
+void BKMaxflowT<Cap>::update( int s, int t )
+{
+	for( int a = 0; a < num_arcs; a++ ) {
+		r_cap[a] = cap[a];
+	}
+	nsource = s;
+	nsink = t;
+	reset();
+} // end of update(int s, int t)
+
+// --- change capacities for the same source/target nodes --- //
+template <class Cap>
+void BKMaxflowT<Cap>::update( const vector<pair<int, Cap> >& changes )
+{
+	bool lists = false, restart = false;
+	for( u_int c = 0; c < changes.size(); c++ ) {
+		int a = arc_pos[changes[c].first];
+		if( a < 0 ) continue;
+		Cap capacity = changes[c].second;
+		Cap fl = cap[a] - r_cap[a]; // flow on a (the opposite arc has none)
+		if( cap[a] == 0 && capacity > 0 ) lists = true; // a is not on the lists
+		cap[a] = capacity;
+		if( capacity < fl ) restart = true;
+		else r_cap[a] = capacity - fl;
+	}
+	if( lists ) relist();
+
+	if( restart ) { // the flow is not feasible any more
+		for( int a = 0; a < num_arcs; a++ ) {
+			r_cap[a] = cap[a];
+		}
+		reset();
+		return;
+	}
+
+	// keep the flow and the trees: a tree may grow along an arc with new
+	// residual capacity, a tree arc without residual capacity is cut
+	for( u_int c = 0; c < changes.size(); c++ ) {
+		int a = arc_pos[changes[c].first];
+		if( a < 0 ) continue;
+		int v1 = head[sister[a]], v2 = head[a];
+		if( unsaturated( r_cap[a] ) ) {
+			if( tree[v1] == SOURCE ) activate( v1 );
+			if( tree[v2] == TARGET ) activate( v2 );
+		}
+		else {
+			if( tree[v2] == SOURCE && parent[v2] == sister[a] ) orphan( v2 );
+			if( tree[v1] == TARGET && parent[v1] == a ) orphan( v1 );
+		}
+	}
+	adopt();
+} // end of update(const vector<pair<int, Cap> >& changes)
+
+// --- build lists for new capacities --- //
+template <class Cap>
+void BKMaxflowT<Cap>::relist()
+{
+	for( int i = 0; i < n; i++ ) {
+		int pos = arc_first[i];
+		for( int a = arc_first[i]; a < arc_first[i + 1]; a++ ) {
+			if( cap[a] > 0 || cap[sister[a]] > 0 ) adj[pos++] = a;
+		}
+		last[i] = pos;
+	}
+} // end of relist()
+
+// --- zero flow, trees of source and target --- //
+template <class Cap>
+void BKMaxflowT<Cap>::reset()
+{
+	for( int i = 0; i < n; i++ ) {
+		tree[i] = FREE;
+		next[i] = -1;
+	}
+	first_active = last_active = -1;
+	orphans.clear();
+	flow = 0;
+	time++;
+
+	tree[nsource] = SOURCE;
+	tree[nsink] = TARGET;
+	parent[nsource] = parent[nsink] = TERMINAL;
+	stamp[nsource] = stamp[nsink] = time;
+	dist[nsource] = dist[nsink] = 0;
+	activate( nsource );
+	activate( nsink );
+} // end of reset()
+
+// --- append node i to the active nodes --- //
+template <class Cap>
+void BKMaxflowT<Cap>::activate( int i )
+{
+	if( next[i] != -1 ) return; // already active
+	next[i] = i;
+	if( last_active != -1 ) next[last_active] = i;
+	else first_active = i;
+	last_active = i;
+} // end of activate(int i)
+
+// --- remove the first active node --- //
+template <class Cap>
+int BKMaxflowT<Cap>::next_active()
+{
+	while( first_active != -1 ) {
+		int i = first_active;
+		first_active = next[i] == i ? -1 : next[i];
+		if( first_active == -1 ) last_active = -1;
+		next[i] = -1;
+		if( tree[i] != FREE ) return i;
+	}
+	return -1;
+} // end of next_active()
+
+// --- growth stage --- //
+template <class Cap>
+int BKMaxflowT<Cap>::grow()
+{
+	int i;
+	while( (i = next_active()) != -1 ) {
+		bool source = tree[i] == SOURCE;
+		for( int p = arc_first[i]; p < last[i]; p++ ) {
+			int a = adj[p];
+			int b = sister[a];
+			// the source tree grows along a, the target tree along b
+			if( !unsaturated( source ? r_cap[a] : r_cap[b] ) ) continue;
+			int j = head[a];
+			if( tree[j] == FREE ) {
+				tree[j] = tree[i];
+				parent[j] = b;
+				stamp[j] = stamp[i];
+				dist[j] = dist[i] + 1;
+				activate( j );
+			}
+			else if( tree[j] != tree[i] ) { // the trees touch
+				activate( i );
+				return source ? a : b;
+			}
+			else if( stamp[j] <= stamp[i] && dist[j] > dist[i] ) {
+				// i is closer to the root (heuristic of the paper)
+				parent[j] = b;
+				stamp[j] = stamp[i];
+				dist[j] = dist[i] + 1;
+			}
+		}
+	}
+	return -1;
+} // end of grow()
+
+// --- augmentation stage --- //
+template <class Cap>
+void BKMaxflowT<Cap>::augment( int a )
+{
+	// bottleneck: arc a, the path to the source, the path to the target
+	Cap delta = r_cap[a];
+	for( int i = head[sister[a]]; parent[i] != TERMINAL; i = head[parent[i]] ) {
+		delta = MIN( delta, r_cap[sister[parent[i]]] );
+	}
+	for( int i = head[a]; parent[i] != TERMINAL; i = head[parent[i]] ) {
+		delta = MIN( delta, r_cap[parent[i]] );
+	}
+
+	r_cap[a] -= delta;
+	r_cap[sister[a]] += delta;
+	for( int i = head[sister[a]]; parent[i] != TERMINAL; ) {
+		int up = parent[i]; // arc from i to its parent, the flow goes against it
+		int down = sister[up];
+		r_cap[down] -= delta;
+		r_cap[up] += delta;
+		int j = head[up];
+		if( !unsaturated( r_cap[down] ) ) orphan( i );
+		i = j;
+	}
+	for( int i = head[a]; parent[i] != TERMINAL; ) {
+		int up = parent[i];
+		r_cap[up] -= delta;
+		r_cap[sister[up]] += delta;
+		int j = head[up];
+		if( !unsaturated( r_cap[up] ) ) orphan( i );
+		i = j;
+	}
+	flow += delta;
+} // end of augment(int a)
+
+template <class Cap>
+void BKMaxflowT<Cap>::orphan( int i )
+{
+	parent[i] = ORPHAN;
+	orphans.push_back( i );
+} // end of orphan(int i)
+
+// --- adoption stage --- //
+template <class Cap>
+void BKMaxflowT<Cap>::adopt()
+{
+	time++;
+	for( u_int o = 0; o < orphans.size(); o++ ) {
+		int i = orphans[o];
+		bool source = tree[i] == SOURCE;
+
+		// the neighbour in the same tree with a residual arc towards i (in
+		// the source tree) or from i (in the target tree) which is closest
+		// to the root, and still connected to it
+		int a_min = -1;
+		int d_min = INFINITE_DIST;
+		for( int p = arc_first[i]; p < last[i]; p++ ) {
+			int a = adj[p];
+			int j = head[a];
+			if( tree[j] != tree[i] ) continue;
+			if( !unsaturated( source ? r_cap[sister[a]] : r_cap[a] ) ) continue;
+			int d = 0;
+			int k = j;
+			while( true ) {
+				if( stamp[k] == time ) {
+					d += dist[k];
+					break;
+				}
+				if( parent[k] == TERMINAL ) {
+					stamp[k] = time;
+					dist[k] = 0;
+					break;
+				}
+				if( parent[k] == ORPHAN ) {
+					d = INFINITE_DIST;
+					break;
+				}
+				d++;
+				k = head[parent[k]];
+			}
+			if( d == INFINITE_DIST ) continue;
+			if( d < d_min ) {
+				a_min = a;
+				d_min = d;
+			}
+			// remember the distances on the path
+			for( k = j; stamp[k] != time; k = head[parent[k]] ) {
+				stamp[k] = time;
+				dist[k] = d--;
+			}
+		}
+
+		if( a_min != -1 ) {
+			parent[i] = a_min;
+			stamp[i] = time;
+			dist[i] = d_min + 1;
+			continue;
+		}
+
+		// no parent: i is free, the tree may grow into it again from its
+		// neighbours, and its children are orphans
+		for( int p = arc_first[i]; p < last[i]; p++ ) {
+			int a = adj[p];
+			int j = head[a];
+			if( tree[j] != tree[i] ) continue;
+			if( unsaturated( source ? r_cap[sister[a]] : r_cap[a] ) ) activate( j );
+			if( parent[j] >= 0 && head[parent[j]] == i ) orphan( j );
+		}
+		tree[i] = FREE;
+	}
+	orphans.clear();
+} // end of adopt()
+
+// --- maximum flow, minimal cut --- //
+template <class Cap>
+Cap BKMaxflowT<Cap>::min_cut( Cap border, int* cut )
+{
+	int a;
+	while( (a = grow()) != -1 ) {
+		augment( a );
+		adopt();
+	}
+
+	// the trees are the nodes reachable from the source and those reaching
+	// the target
+	for( int i = 0; i < n; i++ ) {
+		cut[i] = flow < border ? ( tree[i] == SOURCE ? 1 : tree[i] == TARGET ? 2 : 0 ) : 0;
+	}
+	return flow;
+} // end of min_cut(Cap border, int* cut)
+
+template class BKMaxflowT<double>;
+template class BKMaxflowT<int32_t>;
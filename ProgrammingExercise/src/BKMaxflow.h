@@ -0,0 +1,102 @@
+/* Maximal flow - Boykov-Kolmogorov algorithm */
+/* Y. Boykov, V. Kolmogorov: An experimental comparison of min-cut/max-flow */
+/* algorithms for energy minimization in vision, IEEE PAMI 26(9), 2004 */
+
+#ifndef BKMAXFLOW_H
+#define BKMAXFLOW_H
+
+#include "MinCut.h"
+
+// augmenting paths found by growing a search tree from the source and one
+// from the target until they touch; after an augmentation the trees are
+// repaired (orphans adopted) instead of grown again, and update( changes )
+// keeps them as long as no capacity drops below the flow of its arc
+template <class Cap>
+class BKMaxflowT : public MinCutT<Cap>
+{
+
+public:
+
+	// n = #nodes, m = #arcs, arcs lead from arcs[i].first to arcs[i].second
+	BKMaxflowT( int n, int m, const pair<u_int, u_int> *arcs );
+	// the arcs of the digraph (with their index in digraph.arcs)
+	BKMaxflowT( const Digraph& digraph );
+
+	void update( int s, int t, const Cap *capacities );
+	void update( int s, int t );
+	void update( const vector<pair<int, Cap> >& changes );
+	Cap min_cut( Cap border, int* cut );
+
+private:
+
+	// prevent compiler from auto-generating these
+	BKMaxflowT( const BKMaxflowT& other );
+	BKMaxflowT& operator=( const BKMaxflowT& other );
+
+protected:
+
+	void build( const pair<u_int, u_int> *arcs );
+	// build the lists for new capacities
+	void relist();
+	// zero flow, only source and target in their trees
+	void reset();
+	// residual capacity above CapTraits<Cap>::residual_eps(), as for the
+	// cuts of MaxflowT
+	static bool unsaturated( Cap r )
+	{
+		return r > CapTraits<Cap>::residual_eps();
+	}
+	void activate( int i );
+	// next active node in a tree, -1 if none
+	int next_active();
+	// grow the trees until an arc from the source to the target tree is
+	// found (returned), -1 if there is none (the flow is maximal)
+	int grow();
+	// augment along the path through arc a, make the nodes behind
+	// saturated arcs orphans
+	void augment( int a );
+	// find new parents for the orphans, or free them
+	void adopt();
+	void orphan( int i );
+
+	int n; // #nodes
+	int m; // #arcs (input graph)
+	int num_arcs; // #arcs with opposite arcs, without loops (<= 2m)
+
+	// arcs (one field per array), those leaving node i in
+	// arc_first[i] ... arc_first[i+1]-1, with an opposite arc for each
+	// arc of the input
+	vector<Cap> cap; // capacity
+	vector<Cap> r_cap; // residual capacity
+	vector<int> head; // node the arc leads to
+	vector<int> sister; // opposite arc
+	vector<int> idx; // position in arc array + 1, *(-1) for opposite arcs
+	vector<int> arc_first;
+	vector<int> arc_pos; // position of each arc of the input (-1 for loops)
+
+	// arcs of node i with capacity > 0 in one of both directions:
+	// adj[arc_first[i]] ... adj[last[i]-1]
+	vector<int> adj;
+	vector<int> last;
+
+	// nodes (one field per array)
+	vector<char> tree; // FREE, SOURCE or TARGET (the tree of the node)
+	vector<int> parent; // arc to the parent, TERMINAL or ORPHAN
+	vector<int> next; // next active node, the node itself for the last one, -1 if not active
+	vector<int> stamp; // time of the last distance check
+	vector<int> dist; // distance to the root of the tree (if stamp is recent)
+
+	int nsource; // origin (source node)
+	int nsink; // destination (target node)
+
+	int first_active, last_active;
+	vector<int> orphans;
+	int time; // increased for each adoption
+	Cap flow; // value of the current flow
+
+};
+
+typedef BKMaxflowT<double> BKMaxflow;
+typedef BKMaxflowT<int32_t> IntBKMaxflow;
+
+#endif /* BKMAXFLOW_H */
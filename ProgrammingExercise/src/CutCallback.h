@@ -1,8 +1,7 @@
 #ifndef CUTCALLBACK_H_
 #define CUTCALLBACK_H_
 
-#include "Digraph.h"
-#include "Maxflow.h"
+#include "Separator.h"
 #include <ilcplex/ilocplex.h>
 
 using namespace std;
@@ -69,62 +68,33 @@ public:
 
 };
 
+// legacy user cut and lazy constraint callback for the Separator
 class CutCallback: public LazyConsI, public UserCutI
 {
 
 private:
 
     bool lazy;
-    IloEnv& env;
-    string cut_type;
-    double eps;
-    Digraph& digraph;
-    IloBoolVarArray& x;
-    IloBoolVarArray& z;
-    u_int k;
-    bool cut_early;
-    u_int max_cuts;
+    IloEnv env;
+    // each thread of CPLEX works on its own clone (see duplicateCallback*)
+    // with its own separator
+    Separator separator;
 
     void separate();
 
-    // separate directed connection cuts
-    void connectionCuts();
-
-    // separate cycle elimination cuts
-    void cycleEliminationCuts();
-
-    // used for shortest path computation
-    struct SPNodeT
-    {
-        int pred; // -1 when uninitialized
-        int pred_arc_id; // -1 when uninitialized
-        double weight; // path weight to node
-    };
-    // result of shortest path computation
-    struct SPResultT
-    {
-        list<u_int> path;
-        double weight;
-    };
-    // arc weights for shortest path computation
-    // (should be set according to current LP solution)
-    vector<double> arc_weights;
-    // computes a shortest path from source to target according to arc_weights
-    // in a directed graph:
-    //    number of edges: m -> number of arcs: 2*m
-    //    edge (v1,v2) with id <i> -> arc (v1,v2) with id <i>,
-    //                                arc (v2,v1) with id <i+m>
-    // (returns list of arc ids of a shortest path and the according weight)
-    SPResultT shortestPath( u_int source, u_int target );
-
 public:
 
-    CutCallback( IloEnv& _env, string _cut_type, double _eps,
-                 Digraph& _digraph, IloBoolVarArray& _x,
-                 IloBoolVarArray& _z, u_int _k, bool _cut_early,
-                 u_int _max_cuts );
+    CutCallback( IloEnv _env, const Separator& _separator );
+    // clone with its own workspace
+    CutCallback( const CutCallback& other );
     virtual ~CutCallback();
 
+    // number of nodes to connect (changed between the solves of a k-sweep)
+    void setK( u_int _k )
+    {
+        separator.setK( _k );
+    }
+
     // entry for lazy constraint callback (called for integer solutions)
     virtual void mainLazy()
     {
@@ -135,7 +105,7 @@ public:
 
     virtual IloCplex::CallbackI* duplicateCallbackLazy() const
     {
-        return (LazyConsI *) (this);
+        return (LazyConsI *) ( new CutCallback( *this ) );
     }
 
     // entry for user cut callback (called for fractional solutions)
@@ -148,7 +118,7 @@ public:
 
     virtual IloCplex::CallbackI* duplicateCallbackUser() const
     {
-        return (UserCutI *) (this);
+        return (UserCutI *) ( new CutCallback( *this ) );
     }
 
 };
@@ -0,0 +1,137 @@
+#include "CutPool.h"
+#include <algorithm>
+
+CutPool::CutPool( u_int _max_age ) :
+    added( 0 ), duplicates( 0 ), aged( 0 ), checks( 0 ), answered( 0 ),
+    time( 0 ), max_age( _max_age )
+{
+}
+
+/*
+ * sort the index sets and hash them together with sense and rhs
+ */
+size_t CutPool::canonical( Cut& cut )
+{
+    sort( cut.xs.begin(), cut.xs.end() );
+    sort( cut.zs.begin(), cut.zs.end() );
+    // FNV-1a over the indices, with a separator between the two sets
+    size_t h = 14695981039346656037ULL;
+    for ( u_int i = 0; i < cut.xs.size(); i++ ) {
+        h = ( h ^ cut.xs[i] ) * 1099511628211ULL;
+    }
+    h = ( h ^ 0xffffffffULL ) * 1099511628211ULL;
+    for ( u_int i = 0; i < cut.zs.size(); i++ ) {
+        h = ( h ^ cut.zs[i] ) * 1099511628211ULL;
+    }
+    h = ( h ^ (size_t) cut.sense ) * 1099511628211ULL;
+    h = ( h ^ (size_t) (long) ( cut.rhs * 1024 ) ) * 1099511628211ULL;
+    return h;
+}
+
+bool CutPool::same( const Cut& a, const Cut& b ) const
+{
+    return a.sense == b.sense && a.rhs == b.rhs && a.xs == b.xs &&
+           a.zs == b.zs;
+}
+
+bool CutPool::add( Cut& cut )
+{
+    cut.hash = canonical( cut );
+    cut.age = 0;
+    unique_lock<mutex> guard( lock );
+    pair<unordered_multimap<size_t, u_int>::iterator,
+         unordered_multimap<size_t, u_int>::iterator> range =
+        index.equal_range( cut.hash );
+    for ( ; range.first != range.second; ++range.first ) {
+        Cut& known = cuts[range.first->second];
+        if ( same( known, cut ) ) {
+            known.age = 0;
+            duplicates++;
+            return false;
+        }
+    }
+    index.insert( pair<size_t, u_int>( cut.hash, cuts.size() ) );
+    cuts.push_back( cut );
+    added++;
+    return true;
+}
+
+double CutPool::activity( const Cut& cut, const IloNumArray& xval,
+                          const IloNumArray& zval )
+{
+    double lhs = 0;
+    for ( u_int i = 0; i < cut.xs.size(); i++ ) {
+        lhs += xval[cut.xs[i]];
+    }
+    for ( u_int i = 0; i < cut.zs.size(); i++ ) {
+        lhs -= zval[cut.zs[i]];
+    }
+    return lhs;
+}
+
+u_int CutPool::check( const IloNumArray& xval, const IloNumArray& zval,
+                      double eps, vector<Cut>& violated )
+{
+    double start = Tools::wallTime();
+    unique_lock<mutex> guard( lock );
+    u_int found = 0;
+    u_int kept = 0;
+    for ( u_int c = 0; c < cuts.size(); c++ ) {
+        Cut& cut = cuts[c];
+        double lhs = activity( cut, xval, zval );
+        double slack = ( cut.sense == 'G' ) ? lhs - cut.rhs : cut.rhs - lhs;
+        if ( slack < -eps ) {
+            violated.push_back( cut );
+            found++;
+            cut.age = 0;
+        }
+        else if ( slack <= eps ) {
+            cut.age = 0;
+        }
+        else {
+            cut.age++;
+        }
+        // remove cuts which were not binding for too long
+        if ( cut.age > max_age ) {
+            aged++;
+            continue;
+        }
+        if ( kept != c ) {
+            cuts[kept] = cut;
+        }
+        kept++;
+    }
+    if ( kept != cuts.size() ) {
+        cuts.resize( kept );
+        index.clear();
+        for ( u_int c = 0; c < cuts.size(); c++ ) {
+            index.insert( pair<size_t, u_int>( cuts[c].hash, c ) );
+        }
+    }
+    checks++;
+    if ( found > 0 ) {
+        answered++;
+    }
+    time += Tools::wallTime() - start;
+    return found;
+}
+
+u_int CutPool::size()
+{
+    unique_lock<mutex> guard( lock );
+    return cuts.size();
+}
+
+void CutPool::clear()
+{
+    unique_lock<mutex> guard( lock );
+    cuts.clear();
+    index.clear();
+}
+
+void CutPool::resetCounters()
+{
+    unique_lock<mutex> guard( lock );
+    added = duplicates = aged = checks = answered = 0;
+    time = 0;
+}
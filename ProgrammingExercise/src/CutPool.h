@@ -0,0 +1,80 @@
+#ifndef __CUTPOOL__H__
+#define __CUTPOOL__H__
+
+#include "Tools.h"
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <ilcplex/ilocplex.h>
+
+using namespace std;
+
+// the cuts found by all separators of a solve, shared by all threads:
+// each cut x(X) - z(Z) >= rhs (or <= rhs) is stored once, identified by a
+// hash of its sorted index sets; before separating a point the pool is
+// checked for violated cuts, and a cut which is not binding in <max_age>
+// checks in a row is removed
+class CutPool
+{
+
+public:
+
+    struct Cut
+    {
+        vector<u_int> xs; // indices of the x variables (coefficient 1)
+        vector<u_int> zs; // indices of the z variables (coefficient -1)
+        char sense; // 'G' for >=, 'L' for <=
+        double rhs;
+        u_int age; // checks since the cut was last binding
+        size_t hash;
+    };
+
+    // counters since the last resetCounters()
+    unsigned long added; // new cuts
+    unsigned long duplicates; // cuts found by a separator but already known
+    unsigned long aged; // cuts removed
+    unsigned long checks; // calls of check()
+    unsigned long answered; // calls of check() with violated cuts
+    double time; // wall time spent in check()
+
+    CutPool( u_int _max_age );
+
+    // add a cut found by a separator (its index sets are sorted);
+    // returns false if it was already in the pool
+    bool add( Cut& cut );
+
+    // append the cuts violated by more than <eps> at (xval, zval) to
+    // <violated> and age the others; returns the number of violated cuts
+    u_int check( const IloNumArray& xval, const IloNumArray& zval,
+                 double eps, vector<Cut>& violated );
+
+    // left-hand side of the cut at (xval, zval)
+    static double activity( const Cut& cut, const IloNumArray& xval,
+                            const IloNumArray& zval );
+
+    // number of cuts in the pool
+    u_int size();
+
+    // remove all cuts
+    void clear();
+
+    void resetCounters();
+
+private:
+
+    u_int max_age;
+    mutex lock;
+    vector<Cut> cuts;
+    // position in <cuts> by hash (several for colliding hashes)
+    unordered_multimap<size_t, u_int> index;
+
+    static size_t canonical( Cut& cut );
+    bool same( const Cut& a, const Cut& b ) const;
+
+    // prevent compiler from auto-generating these
+    CutPool( const CutPool& other );
+    CutPool& operator=( const CutPool& other );
+
+};
+
+#endif //__CUTPOOL__H__
@@ -1,8 +1,99 @@
 #include "Digraph.h"
+#include <cstring>
 
-Digraph::Digraph( string file, bool quiet ) : Instance( file, quiet ),
-  n_arcs( 2*n_edges - n_nodes + 1 ), arcs( n_arcs )
+namespace
 {
+  // layout of the binary cache, written in native byte order
+  // (a cache is meant for the machine it was built on, not for exchange):
+  //   CacheHeader
+  //   Edge  edges[n_edges]
+  //   u_int adjStart[n_nodes + 1], adjNode[2 * n_edges], adjEdge[2 * n_edges]
+  //   Arc   arcs[n_arcs]
+  //   u_int outStart[n_nodes + 1], outArc[n_arcs]
+  //   u_int inStart[n_nodes + 1], inArc[n_arcs]
+  const char CACHE_MAGIC[8] = { 'K', 'M', 'S', 'T', 'B', 'I', 'N', '\0' };
+  const u_int CACHE_VERSION = 3;
+
+  struct CacheHeader
+  {
+    char magic[8];
+    u_int version;
+    u_int edge_size, arc_size; // sizeof( Edge ), sizeof( Arc ) of the writer
+    u_int n_nodes, n_edges, n_arcs;
+    // size and checksum of the text file the cache was built from
+    unsigned long long source_size;
+    unsigned long long source_checksum;
+    // checksum of everything following the header
+    unsigned long long checksum;
+  };
+
+  unsigned long long payloadSize( u_int n_nodes, u_int n_edges, u_int n_arcs )
+  {
+    return (unsigned long long) n_edges * sizeof( Instance::Edge ) +
+           (unsigned long long) n_arcs * sizeof( Digraph::Arc ) +
+           ( 3ULL * ( n_nodes + 1 ) + 4ULL * n_edges + 2ULL * n_arcs ) *
+             sizeof( u_int );
+  }
+
+  // size and checksum of the bytes of the text file <source>, false if
+  // it cannot be read
+  bool sourceChecksum( const string& source, unsigned long long& size,
+                       unsigned long long& checksum )
+  {
+    Tools::MappedFile mf;
+    if ( !mf.open( source ) ) {
+      return false;
+    }
+    size = mf.size();
+    checksum = Tools::checksum( mf.data(), mf.size() );
+    return true;
+  }
+
+  // copy one array into / out of the payload
+  template <class T>
+  void put( char*& p, const vector<T>& v )
+  {
+    if ( !v.empty() ) {
+      memcpy( p, &v[0], v.size() * sizeof( T ) );
+    }
+    p += v.size() * sizeof( T );
+  }
+
+  template <class T>
+  void get( const char*& p, vector<T>& v, size_t size )
+  {
+    const T *begin = (const T*) p;
+    v.assign( begin, begin + size );
+    p += size * sizeof( T );
+  }
+}
+
+Digraph::Digraph( string file, bool quiet, bool cache ) : Instance(),
+  n_arcs( 0 )
+{
+  if ( cache && readCache( file, quiet ) ) {
+    return;
+  }
+  readText( file, quiet );
+  buildArcs();
+  if ( cache && !writeCache( file ) ) {
+    cerr << "could not write instance cache " << cacheFile( file ) << endl;
+  }
+}
+
+string Digraph::cacheFile( const string& file )
+{
+  string base( file );
+  if ( base.size() > 4 && base.compare( base.size() - 4, 4, ".dat" ) == 0 ) {
+    base.erase( base.size() - 4 );
+  }
+  return base + ".kmstbin";
+}
+
+void Digraph::buildArcs()
+{
+  n_arcs = 2*n_edges - n_nodes + 1;
+  arcs.resize( n_arcs );
   // add two arc for each edge
   // except for the root node: only from it, not to it
   u_int j = 0;
@@ -47,4 +138,130 @@ Digraph::Digraph( string file, bool quiet ) : Instance( file, quiet ),
   if (j < n_arcs) {
     cerr << "Expected " << n_arcs << " but only got " << j << " arcs" << endl;
   }
+
+  // sort the arc indices by tail and by head node
+  outStart.assign( n_nodes + 1, 0 );
+  inStart.assign( n_nodes + 1, 0 );
+  for ( u_int i = 0; i < n_arcs; i++ ) {
+    outStart[arcs[i].v1 + 1]++;
+    inStart[arcs[i].v2 + 1]++;
+  }
+  for ( u_int v = 0; v < n_nodes; v++ ) {
+    outStart[v + 1] += outStart[v];
+    inStart[v + 1] += inStart[v];
+  }
+  outArc.resize( n_arcs );
+  inArc.resize( n_arcs );
+  vector<u_int> out_pos( outStart.begin(), outStart.end() - 1 );
+  vector<u_int> in_pos( inStart.begin(), inStart.end() - 1 );
+  for ( u_int i = 0; i < n_arcs; i++ ) {
+    outArc[out_pos[arcs[i].v1]++] = i;
+    inArc[in_pos[arcs[i].v2]++] = i;
+  }
+}
+
+bool Digraph::readCache( const string& source, bool quiet )
+{
+  string file = cacheFile( source );
+  Tools::MappedFile mf;
+  if ( !mf.open( file ) || mf.size() < sizeof( CacheHeader ) ) {
+    return false;
+  }
+  CacheHeader h;
+  memcpy( &h, mf.data(), sizeof( h ) );
+  if ( memcmp( h.magic, CACHE_MAGIC, sizeof( CACHE_MAGIC ) ) != 0 ||
+       h.version != CACHE_VERSION ||
+       h.edge_size != sizeof( Edge ) || h.arc_size != sizeof( Arc ) ) {
+    return false;
+  }
+  // the text file has changed since the cache was written (or is gone)
+  unsigned long long source_size, source_checksum;
+  if ( !sourceChecksum( source, source_size, source_checksum ) ||
+       source_size != h.source_size ||
+       source_checksum != h.source_checksum ) {
+    return false;
+  }
+  unsigned long long size = payloadSize( h.n_nodes, h.n_edges, h.n_arcs );
+  if ( mf.size() != sizeof( h ) + size ) {
+    return false;
+  }
+  const char *p = mf.data() + sizeof( h );
+  if ( Tools::checksum( p, size ) != h.checksum ) {
+    return false;
+  }
+
+  if ( !quiet ) {
+    cout << "Reading instance from cache " << file << "\n";
+    cout << "Number of nodes: " << h.n_nodes << "\n";
+    cout << "Number of edges: " << h.n_edges << "\n";
+  }
+  n_nodes = h.n_nodes;
+  n_edges = h.n_edges;
+  n_arcs = h.n_arcs;
+
+  get( p, edges, n_edges );
+  get( p, adjStart, n_nodes + 1 );
+  get( p, adjNode, 2 * n_edges );
+  get( p, adjEdge, 2 * n_edges );
+  get( p, arcs, n_arcs );
+  get( p, outStart, n_nodes + 1 );
+  get( p, outArc, n_arcs );
+  get( p, inStart, n_nodes + 1 );
+  get( p, inArc, n_arcs );
+  return true;
+}
+
+bool Digraph::writeCache( const string& source )
+{
+  unsigned long long source_size, source_checksum;
+  if ( !sourceChecksum( source, source_size, source_checksum ) ) {
+    return false;
+  }
+
+  // assemble the payload in one buffer for the checksum
+  vector<char> payload( payloadSize( n_nodes, n_edges, n_arcs ) );
+  char *p = payload.empty() ? NULL : &payload[0];
+  put( p, edges );
+  put( p, adjStart );
+  put( p, adjNode );
+  put( p, adjEdge );
+  put( p, arcs );
+  put( p, outStart );
+  put( p, outArc );
+  put( p, inStart );
+  put( p, inArc );
+
+  CacheHeader h;
+  memset( &h, 0, sizeof( h ) );
+  memcpy( h.magic, CACHE_MAGIC, sizeof( CACHE_MAGIC ) );
+  h.version = CACHE_VERSION;
+  h.edge_size = sizeof( Edge );
+  h.arc_size = sizeof( Arc );
+  h.n_nodes = n_nodes;
+  h.n_edges = n_edges;
+  h.n_arcs = n_arcs;
+  h.source_size = source_size;
+  h.source_checksum = source_checksum;
+  h.checksum = Tools::checksum( payload.empty() ? NULL : &payload[0],
+                                payload.size() );
+
+  // write to a temporary file first, so a concurrent run never
+  // sees a half-written cache
+  string file = cacheFile( source );
+  char suffix[32];
+  sprintf( suffix, ".%d.tmp", (int) getpid() );
+  string tmp = file + suffix;
+  FILE *f = fopen( tmp.c_str(), "wb" );
+  if ( !f ) {
+    return false;
+  }
+  bool ok = fwrite( &h, sizeof( h ), 1, f ) == 1 &&
+            ( payload.empty() ||
+              fwrite( &payload[0], payload.size(), 1, f ) == 1 );
+  ok = ( fclose( f ) == 0 ) && ok;
+  if ( !ok || rename( tmp.c_str(), file.c_str() ) != 0 ) {
+    remove( tmp.c_str() );
+    return false;
+  }
+  return true;
 }
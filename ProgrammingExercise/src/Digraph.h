@@ -20,9 +20,31 @@ public:
   u_int n_arcs;
   // array of edges
   vector<Arc> arcs;
+  // outgoing and incoming arcs in CSR form: the arcs leaving node v are
+  // outArc[outStart[v]] ... outArc[outStart[v+1]-1] (index in vector
+  // <arcs>), likewise inStart/inArc for the arcs entering v
+  vector<u_int> outStart, outArc;
+  vector<u_int> inStart, inArc;
 
   // constructor
-  Digraph( string file, bool quiet = false );
+  // with <cache> set the instance is loaded from the binary cache file
+  // next to <file> (see cacheFile), which is (re-)written if it is
+  // missing or stale
+  Digraph( string file, bool quiet = false, bool cache = false );
+
+  // name of the binary cache belonging to an instance file
+  static string cacheFile( const string& file );
+
+private:
+
+  // add two arcs for each edge (only one for edges of the root node)
+  // and fill the outgoing/incoming arc arrays
+  void buildArcs();
+
+  // binary cache (*.kmstbin): returns false if the cache is missing,
+  // corrupt or was built from another content of <source>
+  bool readCache( const string& source, bool quiet );
+  bool writeCache( const string& source );
 
 };
 // Digraph
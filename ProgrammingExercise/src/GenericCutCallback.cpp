@@ -0,0 +1,87 @@
+#include "GenericCutCallback.h"
+
+GenericCutCallback::GenericCutCallback( const Separator& separator,
+                                        u_int threads ) :
+    separators( threads )
+{
+    for ( u_int i = 0; i < threads; i++ ) {
+        separators[i] = new Separator( separator );
+    }
+}
+
+GenericCutCallback::~GenericCutCallback()
+{
+    for ( u_int i = 0; i < separators.size(); i++ ) {
+        delete separators[i];
+    }
+}
+
+CPXLONG GenericCutCallback::contexts() const
+{
+    CPXLONG mask = IloCplex::Callback::Context::Id::Candidate;
+    if ( separators[0]->separatesFractional() ) {
+        mask |= IloCplex::Callback::Context::Id::Relaxation;
+    }
+    return mask;
+}
+
+void GenericCutCallback::setK( u_int _k )
+{
+    for ( u_int i = 0; i < separators.size(); i++ ) {
+        separators[i]->setK( _k );
+    }
+}
+
+void GenericCutCallback::invoke( const IloCplex::Callback::Context& context )
+{
+    try {
+        IloInt thread = context.getIntInfo(
+                            IloCplex::Callback::Context::Info::ThreadId );
+        if ( thread < 0 || thread >= (IloInt) separators.size() ) {
+            cerr << "GenericCutCallback: unexpected thread " << thread << endl;
+            exit( -1 );
+        }
+        Separator& separator = *separators[thread];
+        bool lazy = context.inCandidate();
+        if ( lazy ) {
+            if ( !context.isCandidatePoint() ) {
+                // an unbounded ray, cannot happen for this model
+                return;
+            }
+            context.getCandidatePoint( separator.getX(), separator.xval );
+            context.getCandidatePoint( separator.getZ(), separator.zval );
+        }
+        else if ( context.inRelaxation() ) {
+            context.getRelaxationPoint( separator.getX(), separator.xval );
+            context.getRelaxationPoint( separator.getZ(), separator.zval );
+            // there is no node id here: the number of processed nodes only
+            // approximates one, two nodes separated in a row by this thread
+            // may see the same count (their tailing off rounds add up)
+            separator.setRelaxation(
+                context.getLongInfo(
+                    IloCplex::Callback::Context::Info::NodeCount ),
+                context.getRelaxationObjective() );
+        }
+        else {
+            return;
+        }
+        IloRangeArray cuts( context.getEnv() );
+        separator.separate( lazy, cuts );
+        if ( lazy && cuts.getSize() > 0 ) {
+            context.rejectCandidate( cuts );
+        }
+        for ( IloInt i = 0; !lazy && i < cuts.getSize(); i++ ) {
+            context.addUserCut( cuts[i], IloCplex::UseCutForce, IloFalse );
+        }
+        cuts.endElements();
+        cuts.end();
+    }
+    catch( IloException& e ) {
+        cerr << "GenericCutCallback: exception " << e.getMessage();
+        exit( -1 );
+    }
+    catch( ... ) {
+        cerr << "GenericCutCallback: unknown exception.\n";
+        exit( -1 );
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef GENERICCUTCALLBACK_H_
+#define GENERICCUTCALLBACK_H_
+
+#include "Separator.h"
+#include <ilcplex/ilocplex.h>
+
+using namespace std;
+
+// generic callback for the Separator: candidate solutions are rejected
+// with the violated inequalities (like lazy constraints), relaxations get
+// them as user cuts; CPLEX calls invoke() from all its threads
+// concurrently, every thread uses its own separator
+class GenericCutCallback: public IloCplex::Callback::Function
+{
+
+private:
+
+    // one separator per thread (indexed by the thread id of CPLEX)
+    vector<Separator*> separators;
+
+public:
+
+    GenericCutCallback( const Separator& separator, u_int threads );
+    virtual ~GenericCutCallback();
+
+    // contexts to pass to IloCplex::use()
+    CPXLONG contexts() const;
+
+    // number of nodes to connect (changed between the solves of a k-sweep)
+    void setK( u_int _k );
+
+    virtual void invoke( const IloCplex::Callback::Context& context );
+
+private:
+
+    GenericCutCallback( const GenericCutCallback& other );
+    GenericCutCallback& operator=( const GenericCutCallback& other );
+
+};
+
+#endif /* GENERICCUTCALLBACK_H_ */
@@ -1,10 +1,90 @@
 #include "Instance.h"
+#include <limits>
+
+namespace
+{
+	// minimal integer scanner working directly on the mapped file,
+	// keeps track of the line number for error messages
+	struct Scanner
+	{
+		const char *p, *end;
+		u_int line;
+		bool overflow; // the last number did not fit into a long
+
+		Scanner( const char *begin, size_t size ) :
+			p( begin ), end( begin + size ), line( 1 ), overflow( false )
+		{
+		}
+
+		// skip blanks, and also line breaks if <newlines> is set;
+		// returns false on a line break which must not be crossed
+		bool skip( bool newlines )
+		{
+			while( p < end ) {
+				if( *p == '\n' ) {
+					if( !newlines ) return false;
+					line++;
+				}
+				else if( *p != ' ' && *p != '\t' && *p != '\r' ) {
+					break;
+				}
+				p++;
+			}
+			return true;
+		}
+
+		bool atEnd( bool newlines )
+		{
+			return skip( newlines ) && p == end;
+		}
+
+		// read a (possibly negative) integer, returns false if there is none
+		// or if it is out of range (overflow set)
+		bool next( long& v, bool newlines )
+		{
+			overflow = false;
+			if( !skip( newlines ) || p == end ) return false;
+			bool neg = ( *p == '-' );
+			if( neg ) p++;
+			if( p == end || *p < '0' || *p > '9' ) return false;
+			v = 0;
+			while( p < end && *p >= '0' && *p <= '9' ) {
+				int digit = *p - '0';
+				if( v > ( numeric_limits<long>::max() - digit ) / 10 ) {
+					overflow = true;
+					return false;
+				}
+				v = 10 * v + digit;
+				p++;
+			}
+			if( neg ) v = -v;
+			// the number must be followed by white space
+			return p == end || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n';
+		}
+	};
+
+	void parseError( const string& file, u_int line, const char *msg )
+	{
+		cerr << file << ":" << line << ": " << msg << "\n";
+		exit( -1 );
+	}
+}
 
 Instance::Instance( string file, bool quiet ) :
 	n_nodes( 0 ), n_edges( 0 )
 {
-	ifstream ifs( file.c_str() );
-	if( ifs.fail() ) {
+	readText( file, quiet );
+}
+
+Instance::Instance() :
+	n_nodes( 0 ), n_edges( 0 )
+{
+}
+
+void Instance::readText( const string& file, bool quiet )
+{
+	Tools::MappedFile mf;
+	if( !mf.open( file ) ) {
 		cerr << "could not open input file " << file << "\n";
 		exit( -1 );
 	}
@@ -13,20 +93,85 @@ Instance::Instance( string file, bool quiet ) :
 		cout << "Reading instance from file " << file << "\n";
 	}
 
-	ifs >> n_nodes >> n_edges;
+	Scanner sc( mf.data(), mf.size() );
+	long nn, ne;
+	if( !sc.next( nn, true ) || !sc.next( ne, true ) || nn <= 0 || ne < 0 ) {
+		parseError( file, sc.line, sc.overflow ? "number out of range" :
+		            "expected number of nodes and edges" );
+	}
+	// the arc indices (two per edge) must fit into an int
+	if( nn > numeric_limits<int>::max() ||
+	    ne > numeric_limits<int>::max() / 2 ) {
+		parseError( file, sc.line, "number of nodes or edges too large" );
+	}
+	n_nodes = nn;
+	n_edges = ne;
 	if ( !quiet ) {
 		cout << "Number of nodes: " << n_nodes << "\n";
 		cout << "Number of edges: " << n_edges << "\n";
 	}
 
 	edges.resize( n_edges );
-	incidentEdges.resize( n_nodes );
 
-	u_int id;
-	while( ifs >> id ) {
-		ifs >> edges[id].v1 >> edges[id].v2 >> edges[id].weight;
-		incidentEdges[edges[id].v1].push_back( id );
-		incidentEdges[edges[id].v2].push_back( id );
+	// each edge is given on its own line as "id v1 v2 weight"
+	vector<bool> seen( n_edges, false );
+	u_int count = 0;
+	long id, v1, v2, weight;
+	while( !sc.atEnd( true ) ) {
+		if( !sc.next( id, false ) || !sc.next( v1, false ) ||
+			!sc.next( v2, false ) || !sc.next( weight, false ) ) {
+			parseError( file, sc.line, sc.overflow ? "number out of range" :
+			            "expected \"id v1 v2 weight\"" );
+		}
+		if( sc.skip( false ) && sc.p != sc.end ) {
+			parseError( file, sc.line, "trailing characters after edge" );
+		}
+		if( id < 0 || id >= (long) n_edges ) {
+			parseError( file, sc.line, "edge id out of range" );
+		}
+		if( seen[id] ) {
+			parseError( file, sc.line, "duplicate edge id" );
+		}
+		if( v1 < 0 || v1 >= (long) n_nodes || v2 < 0 || v2 >= (long) n_nodes ) {
+			parseError( file, sc.line, "node index out of range" );
+		}
+		if( weight < numeric_limits<int>::min() ||
+		    weight > numeric_limits<int>::max() ) {
+			parseError( file, sc.line, "edge weight out of range" );
+		}
+		seen[id] = true;
+		edges[id].v1 = v1;
+		edges[id].v2 = v2;
+		edges[id].weight = weight;
+		count++;
+	}
+	if( count != n_edges ) {
+		parseError( file, sc.line, "number of edges does not match header" );
+	}
+
+	buildAdjacency();
+}
+
+void Instance::buildAdjacency()
+{
+	// count the degrees, then place each edge at both of its end nodes
+	adjStart.assign( n_nodes + 1, 0 );
+	for( u_int i = 0; i < n_edges; i++ ) {
+		adjStart[edges[i].v1 + 1]++;
+		adjStart[edges[i].v2 + 1]++;
+	}
+	for( u_int v = 0; v < n_nodes; v++ ) {
+		adjStart[v + 1] += adjStart[v];
+	}
+	adjNode.resize( 2 * n_edges );
+	adjEdge.resize( 2 * n_edges );
+	vector<u_int> pos( adjStart.begin(), adjStart.end() - 1 );
+	for( u_int i = 0; i < n_edges; i++ ) {
+		u_int v1 = edges[i].v1;
+		u_int v2 = edges[i].v2;
+		adjNode[pos[v1]] = v2;
+		adjEdge[pos[v1]++] = i;
+		adjNode[pos[v2]] = v1;
+		adjEdge[pos[v2]++] = i;
 	}
-	ifs.close();
 }
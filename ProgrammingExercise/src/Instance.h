@@ -4,7 +4,6 @@
 #include "Tools.h"
 #include <iostream>
 #include <vector>
-#include <list>
 #include <string>
 #include <fstream>
 
@@ -25,12 +24,27 @@ public:
 	u_int n_nodes, n_edges;
 	// array of edges
 	vector<Edge> edges;
-	// incident edges denoted by index in vector <edges>
-	vector<list<u_int> > incidentEdges;
+	// incident edges in CSR form: the edges incident to node v are
+	// adjEdge[adjStart[v]] ... adjEdge[adjStart[v+1]-1] (index in vector
+	// <edges>), adjNode[i] is the node at the other end of adjEdge[i]
+	vector<u_int> adjStart;
+	vector<u_int> adjNode;
+	vector<u_int> adjEdge;
 
 	// constructor
 	Instance( string file, bool quiet = false );
 
+protected:
+
+	// empty instance, to be filled by readText() or from a cache
+	Instance();
+
+	// parse a text instance file (format of data/g*.dat)
+	void readText( const string& file, bool quiet );
+
+	// fill the adjacency arrays from edges
+	void buildAdjacency();
+
 };
 // Instance
 
@@ -2,6 +2,7 @@
 #define __MAIN__CPP__
 
 #include <iostream>
+#include <cstdio>
 #include "Tools.h"
 #include "Digraph.h"
 #include "kMST_ILP.h"
@@ -10,12 +11,49 @@
 #include "kMST_MTZ.h"
 #include "kMST_CEC.h"
 #include "kMST_DCC.h"
+#include "MinCut.h"
 
 using namespace std;
 
 void usage()
 {
     cout << "USAGE:\t<program> -f filename -m model [-q][-v][-c][-n <max_cuts>] [-k <nodes to connect>]\n";
+    cout << "\t\t[-b] [-C] [-e <model file>] [-j <threads>] [-l]\n";
+    cout << "\t\t[-K <from>:<to>[:<step>]] [-t <threads>] [-o] [-L] [-F [-S]]\n";
+    cout << "\t\t[-P <max age>] [-r <seed>] [-T <threshold>[:<rounds>]]\n";
+    cout << "\t\t[-R <points file>] [-M <engine>]\n";
+    cout << "\t-b\tload the instance from its binary cache (*.kmstbin),\n";
+    cout << "\t\twhich is rebuilt if missing or out of date\n";
+    cout << "\t-C\tonly convert the instance into its binary cache and exit\n";
+    cout << "\t-e\texport the model (e.g. model.lp) before solving\n";
+    cout << "\t-j\tnumber of threads for building the model and within\n";
+    cout << "\t\teach separation (default 1)\n";
+    cout << "\t-l\tmcf only: add the flow variables of a commodity only\n";
+    cout << "\t\twhen the solution cannot route it\n";
+    cout << "\t-K\tsolve for k = from, from+step, ... to on the same model\n";
+    cout << "\t\t(step 1 or -1 by default, must point from <from> to <to>)\n";
+    cout << "\t\t(one CSV line \"k,cpu time,nodes,objective\" per k)\n";
+    cout << "\t-t\tnumber of threads for CPLEX (default 1)\n";
+    cout << "\t-o\topportunistic instead of deterministic parallel mode\n";
+    cout << "\t-L\tcec/dcc: use the legacy instead of the generic callbacks\n";
+    cout << "\t-F\tdcc: separate with fractional capacities, with cuts\n";
+    cout << "\t\tlifted to >= z(i), nested cuts and back cuts; fractional\n";
+    cout << "\t\tpoints are separated even without -c\n";
+    cout << "\t-S\twith -F: find the cuts in one sweep over all nodes\n";
+    cout << "\t\tinstead of one maximum flow per node\n";
+    cout << "\t-P\tcec/gsec/dcc: keep the cuts in a pool, checked before\n";
+    cout << "\t\teach separation; cuts not binding in <max age> checks\n";
+    cout << "\t\tare dropped\n";
+    cout << "\t-r\tcec/gsec/dcc: seed for the order of the candidates\n";
+    cout << "\t\twith the same LP value (default 1)\n";
+    cout << "\t-T\tcec/gsec/dcc: stop separating at a node after <rounds>\n";
+    cout << "\t\t(default 3) rounds with a relative bound improvement\n";
+    cout << "\t\tbelow <threshold> (without -L, nodes are told apart\n";
+    cout << "\t\tonly by the number of nodes processed so far)\n";
+    cout << "\t-R\tdcc: write the fractional points separated to a file,\n";
+    cout << "\t\tto be replayed by bench_replay\n";
+    cout << "\t-M\tgsec/dcc: maximum flow algorithm of the separation,\n";
+    cout << "\t\tpr (push-relabel, default) or bk (Boykov-Kolmogorov)\n";
     cout << "EXAMPLE:\t" << "./kmst -f data/g01.dat -m dcc -k 5\n\n";
     exit( 1 );
 } // usage
@@ -32,7 +70,25 @@ int main( int argc, char *argv[] )
     bool cut_early( 0 );
     int max_cuts = 1;
     int k = 5;
-    while( (opt = getopt( argc, argv, "f:m:k:vqcn:" )) != EOF) {
+    bool cache( 0 );
+    bool convert( 0 );
+    string export_file;
+    int workers = 1;
+    bool lazy( 0 );
+    bool sweep( 0 );
+    int k_from = 0, k_to = 0, k_step = 1, fields;
+    int threads = 1;
+    bool opportunistic( 0 );
+    bool legacy( 0 );
+    bool fractional( 0 );
+    bool sweep_cuts( 0 );
+    u_int pool_age( 0 );
+    unsigned int seed( 1 );
+    double tail_threshold( 0 );
+    u_int tail_rounds( 0 );
+    string record_file;
+    string engine( "pr" );
+    while( (opt = getopt( argc, argv, "f:m:k:vqcn:bCe:j:lK:t:oLFSP:r:T:R:M:" )) != EOF) {
         switch( opt ) {
             case 'f': // instance file
                 file = optarg;
@@ -55,20 +111,106 @@ int main( int argc, char *argv[] )
             case 'n': // max. cuts per step
                 max_cuts = atoi( optarg );
                 break;
+            case 'b': // use binary instance cache
+                cache = 1;
+                break;
+            case 'C': // convert instance to binary cache only
+                convert = 1;
+                break;
+            case 'e': // export model
+                export_file = optarg;
+                break;
+            case 'j': // threads for model building and separation
+                workers = atoi( optarg );
+                if ( workers < 1 ) {
+                    usage();
+                }
+                break;
+            case 'l': // lazy commodities (mcf)
+                lazy = 1;
+                break;
+            case 'K': // k-sweep from:to:step
+                fields = sscanf( optarg, "%d:%d:%d", &k_from, &k_to, &k_step );
+                if ( fields < 2 || k_from <= 0 || k_to <= 0 ||
+                     ( fields == 3 && k_step == 0 ) ) {
+                    usage();
+                }
+                if ( fields == 2 ) {
+                    k_step = k_to < k_from ? -1 : 1;
+                }
+                // the step must lead from <from> towards <to>
+                if ( ( k_to - k_from ) * (long) k_step < 0 ) {
+                    usage();
+                }
+                sweep = 1;
+                k = k_from;
+                break;
+            case 't': // threads for CPLEX
+                threads = atoi( optarg );
+                if ( threads < 1 ) {
+                    usage();
+                }
+                break;
+            case 'o': // opportunistic parallel mode
+                opportunistic = 1;
+                break;
+            case 'L': // legacy callbacks
+                legacy = 1;
+                break;
+            case 'F': // fractional dcc separation
+                fractional = 1;
+                break;
+            case 'S': // sweep for fractional dcc separation
+                sweep_cuts = 1;
+                break;
+            case 'P': // cut pool
+                if ( atoi( optarg ) < 0 ) {
+                    usage();
+                }
+                pool_age = atoi( optarg );
+                break;
+            case 'r': // seed of the separators
+                if ( atoi( optarg ) < 0 ) {
+                    usage();
+                }
+                seed = atoi( optarg );
+                break;
+            case 'T': // tailing off threshold[:rounds]
+                tail_rounds = 3;
+                if ( sscanf( optarg, "%lf:%u", &tail_threshold,
+                             &tail_rounds ) < 1 || tail_threshold < 0 ) {
+                    usage();
+                }
+                break;
+            case 'R': // record the separated points
+                record_file = optarg;
+                break;
+            case 'M': // maximum flow algorithm
+                engine = optarg;
+                if ( !MinCut::known( engine ) ) {
+                    usage();
+                }
+                break;
             default:
                 usage();
                 break;
         }
     }
     // read instance
-    Digraph instance( file, quiet );
+    Digraph instance( file, quiet, cache || convert );
+    if ( convert ) {
+        if ( !quiet ) {
+            cout << "Instance cache: " << Digraph::cacheFile( file ) << endl;
+        }
+        return 0;
+    }
     // solve instance
     kMST_ILP *ilp;
     if ( model_type == "scf" ) {
         ilp = new kMST_SCF( instance, k, quiet );
     }
     else if ( model_type == "mcf" ) {
-        ilp = new kMST_MCF( instance, k, quiet );
+        ilp = new kMST_MCF( instance, k, quiet, lazy );
     }
     else if ( model_type == "mtz" ) {
         ilp = new kMST_MTZ( instance, k, quiet );
@@ -76,15 +218,34 @@ int main( int argc, char *argv[] )
     else if ( model_type == "cec" ) {
         ilp = new kMST_CEC( instance, k, quiet, cut_early, max_cuts );
     }
+    else if ( model_type == "gsec" ) {
+        ilp = new kMST_CEC( instance, k, quiet, cut_early, max_cuts, true );
+    }
     else if ( model_type == "dcc" ) {
         ilp = new kMST_DCC( instance, k, quiet, cut_early, max_cuts );
     }
     else {
         cerr << "Sorry, this model '" << model_type << "' is not yet implemented!" << endl;
-        cerr << "You can currently only use 'scf', 'mcf', 'mtz', 'cec' and 'dcc'." << endl;
+        cerr << "You can currently only use 'scf', 'mcf', 'mtz', 'cec', 'gsec' and 'dcc'." << endl;
         return 1;
     }
-    ilp->solve( verbose );
+    ilp->setExport( export_file );
+    ilp->setWorkers( workers );
+    ilp->setThreads( threads, opportunistic );
+    ilp->setLegacy( legacy );
+    ilp->setFractionalCuts( fractional );
+    ilp->setSweepCuts( sweep_cuts );
+    ilp->setCutPool( pool_age );
+    ilp->setSeed( seed );
+    ilp->setTailingOff( tail_threshold, tail_rounds );
+    ilp->setRecord( record_file );
+    ilp->setEngine( engine );
+    if ( sweep ) {
+        ilp->sweep( k_from, k_to, k_step, verbose );
+    }
+    else {
+        ilp->solve( verbose );
+    }
     delete ilp;
 
     return 0;
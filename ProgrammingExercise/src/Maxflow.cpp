@@ -6,95 +6,139 @@
 /* Stefan Slaby - e0127018@student.tuwien.ac.at */
 
 #include "Maxflow.h"
+#include "Digraph.h"
 
 #include <iostream>
 #include <queue>
 #include <utility>
 #include <cstdlib>
 #include <climits>
+#include <limits>
 
 #ifndef ROUND_EPS
 #define ROUND_EPS 0.0001
 #endif
 
-#ifndef FLOW_ROUND_EPS
-#define FLOW_ROUND_EPS 0.0001
-#endif
-
-#define BIGGEST_FLOW LONG_MAX
 #define MIN( a, b ) ( ( ( a ) < ( b ) ) ? ( a ) : ( b ) )
 #define GLOB_UPDT_FREQ 1
 #define WHITE 0
 #define GREY 1
 #define BLACK 2
 
-#define FLOW(a) ( ( a )->cap - ( a )->r_cap )
+// --- constructors --- //
+template <class Cap>
+MaxflowT<Cap>::MaxflowT( int n, int m, list<pair<u_int, u_int> >& arcs ) :
+	n( n ), m( m )
+{
+	allocate();
+	sort_arcs( arcs.begin() );
+}
+
+template <class Cap>
+MaxflowT<Cap>::MaxflowT( int n, int m, const pair<u_int, u_int> *arcs ) :
+	n( n ), m( m )
+{
+	allocate();
+	sort_arcs( arcs );
+}
+
+template <class Cap>
+MaxflowT<Cap>::MaxflowT( const Digraph& digraph ) :
+	n( digraph.n_nodes ), m( digraph.n_arcs )
+{
+	allocate();
+
+	// the block of node i: the arcs leaving i, then the opposite arcs of
+	// those entering i
+	vector<int> forward( m ), backward( m );
+	int current_pos = 0;
+	for( int i = 0; i < n; i++ ) {
+		arc_first[i] = current_pos;
+		for( u_int p = digraph.outStart[i]; p < digraph.outStart[i + 1]; p++ ) {
+			int index = digraph.outArc[p];
+			const Digraph::Arc& arc = digraph.arcs[index];
+			if( arc.v1 == arc.v2 ) continue; // omit self-loops
+			head[current_pos] = arc.v2;
+			idx[current_pos] = index + 1;
+			forward[index] = current_pos++;
+		}
+		for( u_int p = digraph.inStart[i]; p < digraph.inStart[i + 1]; p++ ) {
+			int index = digraph.inArc[p];
+			const Digraph::Arc& arc = digraph.arcs[index];
+			if( arc.v1 == arc.v2 ) continue;
+			head[current_pos] = arc.v1;
+			idx[current_pos] = -(index + 1);
+			backward[index] = current_pos++;
+		}
+	}
+	arc_first[n] = current_pos;
+	this->num_arcs = current_pos;
+	for( int index = 0; index < m; index++ ) {
+		if( digraph.arcs[index].v1 == digraph.arcs[index].v2 ) continue;
+		sister[forward[index]] = backward[index];
+		sister[backward[index]] = forward[index];
+	}
+
+	// there is no artificial arc before the first call to update
+	this->artificial_arc = false;
+}
 
-// --- constructor --- //
-Maxflow::Maxflow( int n, int m, list<pair<u_int, u_int> >& arcs )
+template <class Cap>
+void MaxflowT<Cap>::allocate()
 {
-	this->n = n;
-	this->m = m;
-	
-	// --- initialize long-term arrays that are required in constructor --- //
-	this->nodes = (node*) calloc( n + 1, sizeof(node) );
-	// size n, one past end is a legal pointer
-	this->arcs = (arc*) calloc( 2 * m + 2, sizeof(arc) );
 	// size <=2m + 2 for the artifical arc that might be inserted during update
+	cap.assign( 2 * m + 2, 0 );
+	r_cap.assign( 2 * m + 2, 0 );
+	head.resize( 2 * m + 2 );
+	sister.resize( 2 * m + 2 );
+	idx.assign( 2 * m + 2, 0 );
+	arc_first.resize( n + 1 );
+	adj.resize( 2 * m + n );
+	first.resize( n );
+	last.resize( n );
+	current.resize( n );
+	excess.resize( n );
+	rank.resize( n );
+	q_next.resize( n );
+	nl_prev.resize( n );
+	queue.resize( n );
+	warm = false;
+}
 
+// --- arcs from a sequence of (tail, head) pairs --- //
+template <class Cap>
+template <class ArcIterator>
+void MaxflowT<Cap>::sort_arcs( ArcIterator li )
+{
 	// --- initialize local helper arrays --- //
-	int *counter = (int*) calloc( n + 1, sizeof(int) );
-	int *end = (int*) calloc( n, sizeof(int) );
-	// used for linear sorting of arc structures to keep track of boundaries
-	int *arc_head = (int*) calloc( 2 * m, sizeof(int) );
-	// head of each arc in this->arcs
-	/* temporarily removed, causes a segfault in prefl_to_flow()
-	 arc **position = (arc**) calloc(n*n, sizeof(arc*));
-	 // quadratic memory is necessary to efficiently detect opposite arcs
-	 // for memory-efficiency with large-scale sparse graphs this could in a
-	 // later implementation be replaced with a hashmap */
-
-	if( !this->nodes || !this->arcs || !counter || !end || !arc_head/* || !position*/) {
-		cerr << "Couldn't allocate memory!" << endl;
-	}
+	vector<int> counter( n + 1, 0 );
+	vector<int> end( n );
+	// used for linear sorting of arcs to keep track of boundaries
+	vector<int> arc_tail( 2 * m );
+	// node each arc leaves from
 
-	// --- initialize arcs array, detect opposite arcs --- //
-	arc *current_arc = this->arcs;
+	// --- initialize arcs, detect opposite arcs --- //
 	int current_pos = 0;
-	list<pair<u_int, u_int> >::iterator li = arcs.begin();
 	for( int index = 0; index < m; index++, li++ ) {
-		int head = (int) li->first;
-		int tail = (int) li->second;
-		if( head == tail ) continue; // omit self-loops
-
-		/* temporarily removed, causes a segfault in prefl_to_flow()
-		 arc *other_arc = position[n * head + tail];
-		 if(other_arc) // arc + opposite arc have already been initialized
-		 {
-		 other_arc->idx = index + 1;
-		 }
-		 else*/
-		{
-			counter[head + 1]++;
-			counter[tail + 1]++;
-			// counter[i+1] = number of edges incident to node i
-
-			//position[n * head + tail] = current_arc;
-			current_arc->tail = nodes + tail;
-			current_arc->sister = current_arc + 1;
-			current_arc->idx = index + 1;
-			arc_head[current_pos] = head;
-			current_arc++;
-			current_pos++;
-
-			//position[head + n * tail] = current_arc;
-			current_arc->tail = nodes + head;
-			current_arc->sister = current_arc - 1;
-			current_arc->idx = -(index + 1);
-			arc_head[current_pos] = tail;
-			current_arc++;
-			current_pos++;
-		}
+		int tail = (int) li->first;
+		int to = (int) li->second;
+		if( tail == to ) continue; // omit self-loops
+
+		counter[tail + 1]++;
+		counter[to + 1]++;
+		// counter[i+1] = number of edges incident to node i
+
+		head[current_pos] = to;
+		sister[current_pos] = current_pos + 1;
+		idx[current_pos] = index + 1;
+		arc_tail[current_pos] = tail;
+		current_pos++;
+
+		head[current_pos] = tail;
+		sister[current_pos] = current_pos - 1;
+		idx[current_pos] = -(index + 1);
+		arc_tail[current_pos] = to;
+		current_pos++;
 	}
 	this->num_arcs = current_pos;
 
@@ -103,8 +147,8 @@ Maxflow::Maxflow( int n, int m, list<pair<u_int, u_int> >& arcs )
 
 	// --- ordering arcs, linear-time algorithm --- //
 	// the precise effect of the following code is to re-arrange the arcs 
-	// such that all arcs with the same head are placed in a coherent block
-	// and those blocks are ordered by head index (ascending)
+	// such that all arcs leaving the same node are placed in a coherent block
+	// and those blocks are ordered by node index (ascending)
 
 	// now, counter[i+1] is the number of arcs outgoing from node i
 	for( int i = 0; i < n; i++ ) {
@@ -113,181 +157,238 @@ Maxflow::Maxflow( int n, int m, list<pair<u_int, u_int> >& arcs )
 	}
 	// now,	counter[i] is the position of the first outgoing arc from node i
 	// after they would be ordered
+	arc_first[0] = 0;
+	for( int i = 0; i < n; i++ ) {
+		arc_first[i + 1] = end[i];
+	}
 
 	for( int i = 0; i < n - 1; i++ ) { // scanning all nodes except the last
 		for( int current_pos = counter[i]; current_pos < end[i]; current_pos++ ) {
-			int head = arc_head[current_pos];
-			while( head != i ) {
+			int tail = arc_tail[current_pos];
+			while( tail != i ) {
 				// the arc at current_pos is out of place.
 				// switch it where it belongs, and repeat
-				int other_pos = counter[head];
-				arc *current_arc = this->arcs + current_pos;
-				arc *other_arc = this->arcs + other_pos;
-
-				// swap current_arc and other_arc
-				node *tail_temp = other_arc->tail;
-				other_arc->tail = current_arc->tail;
-				current_arc->tail = tail_temp;
-
-				int idx_temp = other_arc->idx;
-				other_arc->idx = current_arc->idx;
-				current_arc->idx = idx_temp;
-
-				if( other_arc != current_arc->sister ) {
-					arc *arc_temp = other_arc->sister;
-					other_arc->sister = current_arc->sister;
-					current_arc->sister = arc_temp;
-					current_arc->sister->sister = current_arc;
-					other_arc->sister->sister = other_arc;
+				int other_pos = counter[tail];
+
+				// swap the arcs at current_pos and other_pos
+				swap( head[other_pos], head[current_pos] );
+				swap( idx[other_pos], idx[current_pos] );
+
+				if( other_pos != sister[current_pos] ) {
+					swap( sister[other_pos], sister[current_pos] );
+					sister[sister[current_pos]] = current_pos;
+					sister[sister[other_pos]] = other_pos;
 				}
 
-				arc_head[current_pos] = arc_head[other_pos];
-				arc_head[other_pos] = head;
-				counter[head]++;
-				head = arc_head[current_pos];
+				arc_tail[current_pos] = arc_tail[other_pos];
+				arc_tail[other_pos] = tail;
+				counter[tail]++;
+				tail = arc_tail[current_pos];
 			}
 		}
 		// all arcs outgoing from node i are in place
 	}
 	// arcs are ordered
-
-	// --- free local memory --- //
-	free( counter );
-	free( end );
-	free( arc_head );
-	// free(position);
-
-	// --- initialize remaining long-term arrays --- //
-	this->queue = (node**) calloc( n, sizeof(node*) );
-	// queue
-
-	if( !this->queue ) {
-		cerr << "Couldn't allocate memory!" << endl;
-	}
-} // end of constructor
+} // end of sort_arcs(ArcIterator li)
 
 // --- destructor --- //
-Maxflow::~Maxflow()
+template <class Cap>
+MaxflowT<Cap>::~MaxflowT()
 {
-	if( nodes ) free( nodes );
-	if( arcs ) free( arcs );
-	if( queue ) free( queue );
 }
 
 // --- change source/target nodes and arc capacities --- //
-void Maxflow::update( int s, int t, double *capacities )
+template <class Cap>
+void MaxflowT<Cap>::update( int s, int t, const Cap *capacities )
 {
-	// artificial_arc doesn't need to be checked! since the lists are rebuilt either way,
-	// an artificial arc gets automatically removed if it was there
-
-	this->nsource = nodes + s;
-	this->nsink = nodes + t;
+	warm = false;
 
 	// assign (potentially) new capacities
-	for( arc* current_arc = arcs + num_arcs - 1; current_arc >= arcs; current_arc-- ) {
-		if( current_arc->idx > 0 ) current_arc->r_cap = current_arc->cap = capacities[current_arc->idx - 1];
-		else current_arc->r_cap = 0;
+	for( int a = 0; a < num_arcs; a++ ) {
+		if( idx[a] > 0 ) r_cap[a] = cap[a] = capacities[idx[a] - 1];
+		else r_cap[a] = 0;
 	}
 
-	// build lists
-	for( node* current_node = nodes + n - 1; current_node >= nodes; current_node-- ) {
-		current_node->first = (arc*) NULL;
+	rebuild( s, t );
+} // end of update(int s, int t, const Cap *capacities)
+
+// --- change capacities for the same source/target nodes --- //
+template <class Cap>
+void MaxflowT<Cap>::update( const vector<pair<int, Cap> >& changes )
+{
+	if( arc_pos.empty() ) {
+		arc_pos.assign( m, -1 );
+		for( int a = 0; a < num_arcs; a++ ) {
+			if( idx[a] > 0 ) arc_pos[idx[a] - 1] = a;
+		}
 	}
-	for( arc* current_arc = arcs + num_arcs - 1; current_arc >= arcs; current_arc-- ) {
-		// omit edges with 0 capacity in both directions
-		if( current_arc->cap > 0 || current_arc->sister->cap > 0 ) {
-			node *head = current_arc->sister->tail;
-			current_arc->next = head->first;
-			head->first = current_arc;
+
+	flow_excess();
+
+	// set the new capacities; flow above them stays at the tail of the arc
+	// and is missing at its head
+	bool relist = false;
+	for( u_int c = 0; c < changes.size(); c++ ) {
+		int a = arc_pos[changes[c].first];
+		if( a < 0 ) continue;
+		Cap capacity = changes[c].second;
+		int b = sister[a];
+		Cap fl = cap[a] - r_cap[a]; // net flow on a (negative if on b)
+		if( cap[a] == 0 && cap[b] == 0 && capacity > 0 ) relist = true; // not on the lists
+		if( fl > capacity ) {
+			r_cap[a] = 0;
+			r_cap[b] -= fl - capacity;
+			excess[head[b]] += fl - capacity;
+			excess[head[a]] -= fl - capacity;
+		}
+		else {
+			r_cap[a] = capacity - fl;
 		}
+		cap[a] = capacity;
 	}
 
-	// check for direct connection (s, t)
-	artificial_arc = true;
-	for( arc* current_arc = nsource->first; current_arc != NULL; current_arc = current_arc->next ) {
-		if( current_arc->tail == nsink ) // direct connection is already there
-			{
-			artificial_arc = false;
-			break;
+	// a node missing flow reduces its outgoing flow, until the missing flow
+	// reaches the sink (or the source); the flow of an arc or the missing
+	// flow is set to exactly 0, so this ends despite rounding errors
+	const Cap tolerance = -CapTraits<Cap>::deficit_eps();
+	vector<int> deficit;
+	for( int i = 0; i < n; i++ ) {
+		if( excess[i] < tolerance && i != nsource && i != nsink ) deficit.push_back( i );
+	}
+	while( !deficit.empty() ) {
+		int i = deficit.back();
+		deficit.pop_back();
+		for( int a = arc_first[i]; a < arc_first[i + 1] && excess[i] < tolerance; a++ ) {
+			int b = sister[a];
+			Cap delta = cap[a] - r_cap[a];
+			if( delta <= 0 ) continue;
+			if( delta <= -excess[i] ) { // no flow left on a
+				r_cap[a] = cap[a];
+				r_cap[b] = cap[b];
+				excess[i] += delta;
+			}
+			else {
+				delta = -excess[i];
+				r_cap[a] += delta;
+				r_cap[b] -= delta;
+				excess[i] = 0;
+			}
+			int j = head[a];
+			bool missing = excess[j] < tolerance;
+			excess[j] -= delta;
+			if( !missing && excess[j] < tolerance && j != nsource && j != nsink ) {
+				deficit.push_back( j );
+			}
 		}
 	}
-	// build artificial arc (and opposite) at end of arc array if necessary
-	if( artificial_arc ) {
-		arc* current_arc = arcs + num_arcs;
-		// build (nsource, nsink)
-		current_arc->tail = nsink;
-		current_arc->sister = current_arc + 1;
-		current_arc->cap = 0.0;
-		current_arc->r_cap = 0.0;
-		// insert at head of nsource's list
-		current_arc->next = nsource->first;
-		nsource->first = current_arc;
-		current_arc++;
-		// build (nsink, nsource)
-		current_arc->tail = nsource;
-		current_arc->sister = current_arc - 1;
-		current_arc->cap = 0.0;
-		current_arc->r_cap = 0.0;
-		// insert at head of nsink's list
-		current_arc->next = nsink->first;
-		nsink->first = current_arc;
+
+	// what is left are rounding errors; push() only queues a node which
+	// had no excess at all
+	for( int i = 0; i < n; i++ ) {
+		if( excess[i] < 0 && i != nsource && i != nsink ) excess[i] = 0;
+	}
+
+	if( relist ) rebuild( nsource, nsink );
+	warm = true;
+} // end of update(const vector<pair<int, Cap> >& changes)
+
+// --- excesses of the current flow --- //
+template <class Cap>
+void MaxflowT<Cap>::flow_excess()
+{
+	for( int i = 0; i < n; i++ ) {
+		excess[i] = 0;
+		for( int a = arc_first[i]; a < arc_first[i + 1]; a++ ) {
+			// outgoing flow (negative for the opposite arcs of incoming ones)
+			excess[i] -= cap[a] - r_cap[a];
+		}
+	}
+	// as after pr_init() (the flow has left the source)
+	excess[nsource] += CapTraits<Cap>::biggest();
+} // end of flow_excess()
+
+// --- build lists for new capacities --- //
+template <class Cap>
+void MaxflowT<Cap>::rebuild( int s, int t )
+{
+	// artificial_arc doesn't need to be checked! since the lists are rebuilt either way,
+	// an artificial arc gets automatically removed if it was there
+
+	this->nsource = s;
+	this->nsink = t;
+
+	// build lists, omitting arcs with 0 capacity in both directions
+	int pos = 0;
+	for( int i = 0; i < n; i++ ) {
+		pos++; // free position for the artificial arc
+		first[i] = pos;
+		for( int a = arc_first[i]; a < arc_first[i + 1]; a++ ) {
+			if( cap[a] > 0 || cap[sister[a]] > 0 ) {
+				adj[pos++] = a;
+			}
+		}
+		last[i] = pos;
 	}
-} // end of update(int s, int t, double *capacities)
+
+	add_artificial_arc();
+} // end of rebuild(int s, int t)
 
 // --- change source/target nodes --- //
-void Maxflow::update( int s, int t )
+template <class Cap>
+void MaxflowT<Cap>::update( int s, int t )
 {
+	warm = false;
+
 	// remove artificial arc from lists if necessary
 	if( artificial_arc ) {
-		nsource->first = nsource->first->next;
-		nsink->first = nsink->first->next;
+		first[nsource]++;
+		first[nsink]++;
 	}
 
-	this->nsource = nodes + s;
-	this->nsink = nodes + t;
+	this->nsource = s;
+	this->nsink = t;
 
 	// reset capacities
-	for( arc* current_arc = arcs + num_arcs - 1; current_arc >= arcs; current_arc-- ) {
-		current_arc->r_cap = current_arc->cap;
+	for( int a = 0; a < num_arcs; a++ ) {
+		r_cap[a] = cap[a];
 	}
 
+	add_artificial_arc();
+} // end of update(int s, int t)
+
+// --- insert artificial arc if necessary --- //
+template <class Cap>
+void MaxflowT<Cap>::add_artificial_arc()
+{
 	// check for direct connection (s, t)
 	artificial_arc = true;
-	for( arc* current_arc = nsource->first; current_arc != NULL; current_arc = current_arc->next ) {
-		if( current_arc->tail == nsink ) // direct connection is already there
-			{
+	for( int p = first[nsource]; p < last[nsource]; p++ ) {
+		if( head[adj[p]] == nsink ) { // direct connection is already there
 			artificial_arc = false;
 			break;
 		}
 	}
-	// build artificial arc (and opposite) at end of arc array.
+	// build artificial arc (and opposite) at end of arc array if necessary
 	if( artificial_arc ) {
-		arc* current_arc = arcs + num_arcs;
-		// build (nsource, nsink)
-		current_arc->tail = nsink;
-		current_arc->sister = current_arc + 1;
-		current_arc->cap = 0.0;
-		current_arc->r_cap = 0.0;
-		// insert at head of nsource's list
-		current_arc->next = nsource->first;
-		nsource->first = current_arc;
-		current_arc++;
-		// build (nsink, nsource)
-		current_arc->tail = nsource;
-		current_arc->sister = current_arc - 1;
-		current_arc->cap = 0.0;
-		current_arc->r_cap = 0.0;
-		// insert at head of nsink's list
-		current_arc->next = nsink->first;
-		nsink->first = current_arc;
+		int a = num_arcs;
+		// build (nsource, nsink), insert at head of nsource's list
+		head[a] = nsink;
+		sister[a] = a + 1;
+		cap[a] = r_cap[a] = 0.0;
+		adj[--first[nsource]] = a;
+		// build (nsink, nsource), insert at head of nsink's list
+		head[a + 1] = nsource;
+		sister[a + 1] = a;
+		cap[a + 1] = r_cap[a + 1] = 0.0;
+		adj[--first[nsink]] = a + 1;
 	}
-
-} // end of update(int s, int t)
+} // end of add_artificial_arc()
 
 // --- find first and last minimal cuts --- //
-double Maxflow::min_cut( double border, int* cut )
+template <class Cap>
+Cap MaxflowT<Cap>::min_cut( Cap border, int* cut )
 {
-	double f = 0;
+	Cap f = 0;
 	int e = 0;
 
 	if( (e = prflow( &f )) ) {
@@ -300,97 +401,104 @@ double Maxflow::min_cut( double border, int* cut )
 
 	if( f < border ) {
 		std::queue<int> Q;
-		Q.push( nsource - nodes );
-		cut[nsource - nodes] = 1;
+		Q.push( nsource );
+		cut[nsource] = 1;
 
 		while( !Q.empty() ) {
-			node akt = nodes[Q.front()];
+			int akt = Q.front();
 			Q.pop();
 
-			arc *a = akt.first;
-			while( a ) {
-				if( a->r_cap > 0 && cut[a->tail - nodes] == 0 ) {
-					cut[a->tail - nodes + 0] = 1;
-					Q.push( a->tail - nodes );
+			for( int p = first[akt]; p < last[akt]; p++ ) {
+				int a = adj[p];
+				if( r_cap[a] > CapTraits<Cap>::residual_eps() &&
+				    cut[head[a]] == 0 ) {
+					cut[head[a]] = 1;
+					Q.push( head[a] );
 				}
-				a = a->next;
 			}
 		}
 
-		Q.push( nsink - nodes );
-		cut[nsink - nodes] = 2;
+		Q.push( nsink );
+		cut[nsink] = 2;
 
 		while( !Q.empty() ) {
-			node akt = nodes[Q.front()];
+			int akt = Q.front();
 			Q.pop();
 
-			arc * a = akt.first;
-			while( a ) {
-				if( a->sister->r_cap > 0 && cut[a->tail - nodes] == 0 ) {
-					cut[a->tail - nodes] = 2;
-					Q.push( a->tail - nodes );
+			for( int p = first[akt]; p < last[akt]; p++ ) {
+				int a = adj[p];
+				if( r_cap[sister[a]] > CapTraits<Cap>::residual_eps() &&
+				    cut[head[a]] == 0 ) {
+					cut[head[a]] = 2;
+					Q.push( head[a] );
 				}
-				a = a->next;
 			}
 		}
 	}
 
 	return f;
-} // end of min_cut(double border, int **cut)
+} // end of min_cut(Cap border, int **cut)
 
 // --- initialization --- //
-int Maxflow::pr_init()
+template <class Cap>
+int MaxflowT<Cap>::pr_init()
 {
-	for( node *i = nodes; i < nodes + n; i++ )
-		i->excess = 0;
+	lmax = n - 1;
 
-	nsource->excess = BIGGEST_FLOW;
+	if( warm ) { // excesses of the flow kept by update( changes )
+		warm = false;
+		return 0;
+	}
 
-	lmax = n - 1;
+	for( int i = 0; i < n; i++ )
+		excess[i] = 0;
+
+	excess[nsource] = CapTraits<Cap>::biggest();
 
 	return 0;
 } // end of pr_init()
 
 // --- global rank update - breadth first search --- //
-void Maxflow::def_ranks()
+template <class Cap>
+void MaxflowT<Cap>::def_ranks()
 {
 	// initialization
-	for( node *i = nodes; i < nodes + n; i++ )
-		i->rank = n;
+	for( int i = 0; i < n; i++ )
+		rank[i] = n;
 
-	nsink->rank = 0;
+	rank[nsink] = 0;
 
-	*queue = nsink;
-	qp_first = qp_last = NULL;
+	queue[0] = nsink;
+	qp_first = qp_last = -1;
 
 	lmax = 0;
 
 	// breadth first search
-	for( q_read = queue, q_write = queue + 1; q_read != q_write; q_read++ ) {
+	for( int q_read = 0, q_write = 1; q_read != q_write; q_read++ ) {
 		// scanning arcs incident to node i
-		node *i = *q_read;
-		long j_rank = i->rank + 1;
+		int i = queue[q_read];
+		int j_rank = rank[i] + 1;
 
-		for( arc *a = i->first; a != NULL; a = a->next ) {
-			node *j = a->tail;
+		for( int p = first[i]; p < last[i]; p++ ) {
+			int a = adj[p];
+			int j = head[a];
 
-			if( j->rank == n ) // j is not labelled
+			if( rank[j] == n ) // j is not labelled
 				{
-				if( a->sister->r_cap > 0 ) // arc (j, i) is not saturated
+				if( r_cap[sister[a]] > 0 ) // arc (j, i) is not saturated
 					{
-					j->rank = j_rank;
-					j->current = j->first;
+					rank[j] = j_rank;
+					current[j] = first[j];
 
 					if( j_rank > lmax ) lmax = j_rank;
 
-					if( j->excess > 0 ) {
-						j->q_next = qp_first;
-						if( qp_first == NULL ) qp_last = j;
+					if( excess[j] > 0 ) {
+						q_next[j] = qp_first;
+						if( qp_first == -1 ) qp_last = j;
 						qp_first = j;
 					}
 
-					*q_write = j;
-					q_write++; // put j  to scanning queue
+					queue[q_write++] = j; // put j  to scanning queue
 				}
 			}
 		} // node i is scanned
@@ -398,69 +506,73 @@ void Maxflow::def_ranks()
 } // end of def_ranks()
 
 // --- pushing flow from node i --- //
-int Maxflow::push( node *i )
+template <class Cap>
+int MaxflowT<Cap>::push( int i )
 {
-	arc *a; // current arc (i,j)
+	int p; // position of the current arc (i,j)
 
-	long j_rank = (i->rank) - 1; // rank of the next layer
+	int j_rank = rank[i] - 1; // rank of the next layer
 
 	// scanning arcs outgoing from i
-	for( a = i->current; a != NULL; a = a->next ) {
-		if( a->r_cap > 0 ) // a is not saturated
+	for( p = current[i]; p < last[i]; p++ ) {
+		int a = adj[p];
+		if( r_cap[a] > 0 ) // a is not saturated
 			{
-			node *j = a->tail;
+			int j = head[a];
 
-			if( j->rank == j_rank ) // j belongs to the next layer
+			if( rank[j] == j_rank ) // j belongs to the next layer
 				{
-				double fl = MIN( i->excess, a->r_cap );
+				Cap fl = MIN( excess[i], r_cap[a] );
 
-				a->r_cap -= fl;
-				a->sister->r_cap += fl;
+				r_cap[a] -= fl;
+				r_cap[sister[a]] += fl;
 
 				if( j_rank > 0 ) {
-					if( j->excess == 0 ) // before current push j had zero excess
+					if( excess[j] == 0 ) // before current push j had zero excess
 						{
 						// put j to the push-list
 
-						if( qp_first != NULL ) qp_last->q_next = j;
+						if( qp_first != -1 ) q_next[qp_last] = j;
 						else qp_first = j;
 
 						qp_last = j;
-						j->q_next = NULL;
-					} // j->excess == 0
-				} // j->rank > 0
+						q_next[j] = -1;
+					} // excess[j] == 0
+				} // rank[j] > 0
 
-				j->excess += fl;
-				i->excess -= fl;
+				excess[j] += fl;
+				excess[i] -= fl;
 
-				if( i->excess == 0 ) break;
+				if( excess[i] == 0 ) break;
 
 			} // j belongs to the next layer
 		} // a is not saturated
 	} // end of scanning arcs from i
 
-	i->current = a;
+	current[i] = p;
 
-	return ((a == NULL) ? 1 : 0);
+	return ((p == last[i]) ? 1 : 0);
 }
-// end of push(node *i)
+// end of push(int i)
 
 // --- relabeling node i --- //
-long Maxflow::relabel( node *i )
+template <class Cap>
+int MaxflowT<Cap>::relabel( int i )
 {
-	long j_rank; // minimal rank of a node available from j
-	arc *a_j = NULL; // an arc which leads to the node with minimal rank
+	int j_rank; // minimal rank of a node available from j
+	int p_j = -1; // position of an arc which leads to the node with minimal rank
 
-	i->rank = j_rank = n;
+	rank[i] = j_rank = n;
 
 	// looking for a node with minimal rank available from i
-	for( arc *a = i->first; a != NULL; a = a->next ) {
-		if( a->r_cap > 0 ) {
-			node *j = a->tail;
-
-			if( j->rank < j_rank ) {
-				j_rank = j->rank;
-				a_j = a;
+	for( int p = first[i]; p < last[i]; p++ ) {
+		int a = adj[p];
+		if( r_cap[a] > 0 ) {
+			int j = head[a];
+
+			if( rank[j] < j_rank ) {
+				j_rank = rank[j];
+				p_j = p;
 			}
 		}
 	}
@@ -469,18 +581,19 @@ long Maxflow::relabel( node *i )
 	if( j_rank < n ) {
 		// siting i into the manual
 
-		i->rank = j_rank;
-		i->current = a_j;
+		rank[i] = j_rank;
+		current[i] = p_j;
 
 		if( j_rank > lmax ) lmax = j_rank;
 
 	} // end of j_rank < n
 
 	return j_rank;
-} // end of relabel(node *i)
+} // end of relabel(int i)
 
 // --- organizer --- //
-int Maxflow::prflow( double *fl )
+template <class Cap>
+int MaxflowT<Cap>::prflow( Cap *fl )
 {
 	int cc = pr_init(); // condition code
 	if( cc ) return cc;
@@ -490,20 +603,20 @@ int Maxflow::prflow( double *fl )
 	long n_r = 0; // the number of relabels
 
 	// queue method
-	while( qp_first != NULL ) // main loop
+	while( qp_first != -1 ) // main loop
 	{
 		if( n_r > GLOB_UPDT_FREQ * (float) n ) // it is time for global update
 			{
 			def_ranks();
 			n_r = 0;
-			if( qp_first == NULL ) break;
+			if( qp_first == -1 ) break;
 		}
 
-		node *i = qp_first;
-		qp_first = qp_first->q_next;
-		if( qp_first == NULL ) qp_last = NULL;
+		int i = qp_first;
+		qp_first = q_next[qp_first];
+		if( qp_first == -1 ) qp_last = -1;
 
-		long i_rank = i->rank;
+		int i_rank = rank[i];
 
 		while( i_rank < n ) {
 			// until i will be free from excess or beyond the gap
@@ -515,12 +628,12 @@ int Maxflow::prflow( double *fl )
 		} // end of scanning i
 	} // end of the main loop
 
-	*fl += nsink->excess;
+	*fl += excess[nsink];
 
 	prefl_to_flow();
 
 	return 0;
-} // end of prflow(double *fl)
+} // end of prflow(Cap *fl)
 
 // --- removing excessive flow - second phase of PR-algorithm --- //
 // do dfs in the reverse flow graph from nodes with excess
@@ -529,87 +642,88 @@ int Maxflow::prflow( double *fl )
 // - rank is used for dfs labels
 // - nl_prev is used for DFS tree
 // - q_next is used for topological order list
-void Maxflow::prefl_to_flow()
+template <class Cap>
+void MaxflowT<Cap>::prefl_to_flow()
 {
 	// initialize
-	node *bos = NULL, *tos = NULL;
-	for( node *i = nodes; i < nodes + n; i++ ) {
-		i->rank = WHITE;
-		i->nl_prev = NULL;
-		i->current = i->first;
+	int bos = -1, tos = -1;
+	for( int i = 0; i < n; i++ ) {
+		rank[i] = WHITE;
+		nl_prev[i] = -1;
+		current[i] = first[i];
 	}
 
-	for( node *i = nodes; i < nodes + n; i++ ) {
-		if( (i->rank == WHITE) && (i->excess > 0) && (i != nsource) && (i != nsink) ) {
-			node *r = i;
-			r->rank = GREY;
+	for( int i = 0; i < n; i++ ) {
+		if( (rank[i] == WHITE) && (excess[i] > 0) && (i != nsource) && (i != nsink) ) {
+			int r = i;
+			rank[r] = GREY;
 			while( 1 ) {
-				for( /*no init*/; i->current != NULL; i->current = i->current->next ) {
-					arc *a = i->current;
-					if( (a->cap == 0) && (a->r_cap > 0) && (a->tail != nsource) && (a->tail != nsink) ) {
-						node *j = a->tail;
-						if( j->rank == WHITE ) {
+				for( /*no init*/; current[i] < last[i]; current[i]++ ) {
+					int a = adj[current[i]];
+					if( (cap[a] == 0) && (r_cap[a] > 0) && (head[a] != nsource) && (head[a] != nsink) ) {
+						int j = head[a];
+						if( rank[j] == WHITE ) {
 							// start scanning j
-							j->rank = GREY;
-							j->nl_prev = i;
+							rank[j] = GREY;
+							nl_prev[j] = i;
 							i = j;
 							break;
 						}
-						else if( j->rank == GREY ) {
+						else if( rank[j] == GREY ) {
 							// find minimum flow on the cycle
-							double delta = a->r_cap;
+							Cap delta = r_cap[a];
 							while( 1 ) {
-								delta = MIN( delta, j->current->r_cap );
+								delta = MIN( delta, r_cap[adj[current[j]]] );
 								if( j == i ) break;
-								else j = j->current->tail;
+								else j = head[adj[current[j]]];
 							}
 
 							// remove delta flow units
 							j = i;
 							while( 1 ) {
-								a = j->current;
-								a->r_cap -= delta;
-								a->sister->r_cap += delta;
-								j = a->tail;
+								a = adj[current[j]];
+								r_cap[a] -= delta;
+								r_cap[sister[a]] += delta;
+								j = head[a];
 								if( j == i ) break;
 							}
 
 							// back DFS to the first zeroed arc
-							node *restart = i;
-							for( j = i->current->tail; j != i; j = a->tail ) {
-								a = j->current;
-								if( (j->rank == WHITE) || (a->r_cap == 0) ) {
-									j->current->tail->rank = WHITE;
-									if( j->rank != WHITE ) restart = j;
+							int restart = i;
+							for( j = head[adj[current[i]]]; j != i; j = head[a] ) {
+								a = adj[current[j]];
+								if( (rank[j] == WHITE) || (r_cap[a] == 0) ) {
+									rank[head[adj[current[j]]]] = WHITE;
+									if( rank[j] != WHITE ) restart = j;
 								}
 							}
 
 							if( restart != i ) {
 								i = restart;
-								i->current = i->current->next;
+								current[i]++;
 								break;
 							}
 						}
 					}
 				}
 
-				if( i->current == NULL ) {
+				if( current[i] == last[i] ) {
 					// scan of i complete
-					i->rank = BLACK;
+					rank[i] = BLACK;
 					if( i != nsource ) {
-						if( bos == NULL ) {
+						if( bos == -1 ) {
 							bos = i;
 							tos = i;
 						}
 						else {
-							i->q_next = tos;
+							q_next[i] = tos;
 							tos = i;
 						}
 					}
 
 					if( i != r ) {
-						i = i->nl_prev;
-						i->current = i->current->next;
+						i = nl_prev[i];
+						current[i]++;
 					}
 					else break;
 				}
@@ -619,34 +733,30 @@ void Maxflow::prefl_to_flow()
 
 	// return excesses
 	// note that sink is not on the stack
-	if( bos != NULL ) {
-		node *i = tos;
+	if( bos != -1 ) {
+		int i = tos;
 		while( 1 ) {
-			arc *a = i->first;
-
-			// Inserted to avoid segfault!!
-			if( a != NULL ) {
-				// Inserted to avoid segfault!!
-
-				while( i->excess > FLOW_ROUND_EPS ) {
-					if( !a ) cout << "a is NULL, Excess left is " << i->excess << endl;
-
-					if( (a->cap == 0) && (a->r_cap > 0) ) {
-						double delta = MIN( i->excess, a->r_cap );
-						a->r_cap -= delta;
-						a->sister->r_cap += delta;
-						i->excess -= delta;
-						a->tail->excess += delta;
-					}
-					a = a->next;
+			int p = first[i];
+			while( p < last[i] && excess[i] > CapTraits<Cap>::round_eps() ) {
+				int a = adj[p];
+				if( (cap[a] == 0) && (r_cap[a] > 0) ) {
+					Cap delta = MIN( excess[i], r_cap[a] );
+					r_cap[a] -= delta;
+					r_cap[sister[a]] += delta;
+					excess[i] -= delta;
+					excess[head[a]] += delta;
 				}
-				// Inserted to avoid segfault!!
+				p++;
+			}
+			if( excess[i] > CapTraits<Cap>::round_eps() ) {
+				cout << "Excess left is " << excess[i] << endl;
 			}
-			// Inserted to avoid segfault!!
 
 			if( i == bos ) break;
-			else i = i->q_next;
+			else i = q_next[i];
 		}
 	}
 } // end of prefl_to_flow()
 
+template class MaxflowT<double>;
+template class MaxflowT<int32_t>;
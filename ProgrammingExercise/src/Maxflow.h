@@ -8,94 +8,124 @@
 #ifndef MAXFLOW_H
 #define MAXFLOW_H
 
-#include <utility>
+#include "MinCut.h"
 #include <list>
 
-using namespace std;
-typedef unsigned int u_int;
-
-class Maxflow
+// push-relabel maximum flow with capacities of type Cap, instantiated for
+// double (see Maxflow) and int32_t (see IntMaxflow)
+template <class Cap>
+class MaxflowT : public MinCutT<Cap>
 {
 
-private:
-
-	struct node; // forward declaration because of circular dependency
-
-	struct arc
-	{
-		double cap; // capacity
-		double r_cap; // residual capacity
-		int idx; // position in arc array + 1, *(-1) for auto-generated opposite arcs
-		node *tail; // tail node
-		arc *sister; // opposite arc
-		arc *next; // next arc with the same head
-	};
-
-	struct node
-	{
-		arc *first; // first outgoing arc
-		arc *current; // current incident arc
-		double excess; // excess of the node
-		long rank; // distance from the sink
-		node *q_next; // next node in queue
-		node *nl_prev; // used by prefl_to_flow
-	};
-
 public:
 
 	// n = #nodes, m = #arcs
 	// expects node indices to range from 0 to n-1
 	// arcs are assumed to lead from node arc->first to node arc->second
-	Maxflow( int n, int m, list<pair<u_int, u_int> >& arcs );
+	MaxflowT( int n, int m, list<pair<u_int, u_int> >& arcs );
+	// the same with the arcs in an array of m pairs
+	MaxflowT( int n, int m, const pair<u_int, u_int> *arcs );
+	// the arcs of the digraph (with their index in digraph.arcs), taken
+	// directly from its outgoing and incoming arc lists
+	MaxflowT( const Digraph& digraph );
 
-	~Maxflow();
+	~MaxflowT();
 
 	// must be called at least once before using the algorithm
 	// calling the algorithm first yields undefined behaviour
 	// capacities must be in the same order as arcs have been passed to constructor
-	void update( int s, int t, double *capacities );
+	void update( int s, int t, const Cap *capacities );
+
+	// the same with the capacities from any buffer indexed by the arcs, e.g.
+	// an IloNumArray or a vector (values are converted to Cap)
+	template <class Buffer>
+	void update( int s, int t, const Buffer& capacities )
+	{
+		warm = false;
+		for( int a = 0; a < num_arcs; a++ ) {
+			if( idx[a] > 0 ) r_cap[a] = cap[a] = (Cap) capacities[idx[a] - 1];
+			else r_cap[a] = 0;
+		}
+		rebuild( s, t );
+	}
 
 	// use this to change source / target nodes without changing capacities
 	void update( int s, int t );
 
+	// change the capacities of some arcs (index as passed to the constructor,
+	// new capacity) for the same source and target: the next min_cut()
+	// starts from the current flow (of the last min_cut(), or 0 after the
+	// other updates), with the flow above the new capacities sent back
+	void update( const vector<pair<int, Cap> >& changes );
+
 	// returns capacity of the minimal cut (return value works only once per update()!)
 	// will be performed only if value of minimal cut is < border
 	// cut[i] gets assigned the following values:
 	//    0 if there are minimal cuts both with and without node i
 	//    1 if node i is on source side of the first (and therefore each) minimal cut
 	//    2 if node i is on target side of the last (and therefore each) minimal cut
-	double min_cut( double border, int* cut );
+	Cap min_cut( Cap border, int* cut );
 
 private:
 
 	// prevent compiler from auto-generating these
-	Maxflow( const Maxflow& other );
-	Maxflow& operator=( const Maxflow& other );
+	MaxflowT( const MaxflowT& other );
+	MaxflowT& operator=( const MaxflowT& other );
 
 protected:
 
+	void allocate();
+	template <class ArcIterator>
+	void sort_arcs( ArcIterator arcs );
+	// set source and target, build the lists for new capacities
+	void rebuild( int s, int t );
+	// excess of each node for the flow in r_cap
+	void flow_excess();
+
 	int pr_init();
 	void def_ranks();
-	int push( node *i );
-	long relabel( node *i );
-	int prflow( double *fl );
+	int push( int i );
+	int relabel( int i );
+	int prflow( Cap *fl );
 	void prefl_to_flow();
+	// insert the artificial arc (see below) if there is no arc (nsource, nsink)
+	void add_artificial_arc();
 
 	int n; // #nodes
 	int m; // #arcs (input graph)
 	int num_arcs; // #arcs with opposing arcs / without loops (<= 2m)
 
-	node *nodes; // array of nodes
-	arc *arcs; // array of arcs
-
-	node *nsource; // origin (source node)
-	node *nsink; // destination (target node)
-
-	node **queue; // queue for storing nodes
-	node **q_read, **q_write; // queue pointers
-	node *qp_first, *qp_last; // start and end of push-queue
-
-	long lmax; // maximal layer
+	// arcs (one field per array), those leaving node i in
+	// arc_first[i] ... arc_first[i+1]-1; the artificial arc is num_arcs,
+	// its opposite arc num_arcs + 1
+	vector<Cap> cap; // capacity
+	vector<Cap> r_cap; // residual capacity
+	vector<int> head; // node the arc leads to
+	vector<int> sister; // opposite arc
+	vector<int> idx; // position in arc array + 1, *(-1) for auto-generated opposite arcs
+	vector<int> arc_first;
+
+	// arcs of node i used by the algorithm (capacity > 0 in one of both
+	// directions): adj[first[i]] ... adj[last[i]-1]; the position before
+	// them is kept free for the artificial arc
+	vector<int> adj;
+	vector<int> first;
+	vector<int> last;
+
+	// nodes (one field per array), -1 for no node
+	vector<int> current; // position of the current incident arc in adj
+	vector<Cap> excess; // excess of the node
+	vector<int> rank; // distance from the sink
+	vector<int> q_next; // next node in queue
+	vector<int> nl_prev; // used by prefl_to_flow
+
+	int nsource; // origin (source node)
+	int nsink; // destination (target node)
+
+	vector<int> queue; // queue for storing nodes
+	int qp_first, qp_last; // start and end of push-queue
+
+	int lmax; // maximal layer
 
 	// to ensure that there always is at least one path from source to sink (requirement
 	// of the original algorithm), both update methods insert an artificial
@@ -103,7 +133,19 @@ protected:
 	// has to be removed on later updates, this variable keeps track of it
 	bool artificial_arc;
 
+	// position of each arc of the input (-1 for loops), built for the first
+	// update( changes )
+	vector<int> arc_pos;
+	// pr_init() keeps the excesses set by update( changes )
+	bool warm;
+
 };
 
-#endif /* MAXFLOW_H */
+// fractional capacities, values below FLOW_ROUND_EPS are rounding errors
+typedef MaxflowT<double> Maxflow;
 
+// integer capacities (e.g. 0/1 on the support of a solution), exact and
+// with half the memory per capacity; their sum must fit into an int32_t
+typedef MaxflowT<int32_t> IntMaxflow;
+
+#endif /* MAXFLOW_H */
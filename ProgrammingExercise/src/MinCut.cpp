@@ -0,0 +1,24 @@
+#include "MinCut.h"
+#include "Maxflow.h"
+#include "BKMaxflow.h"
+
+template <class Cap>
+MinCutT<Cap>* MinCutT<Cap>::create( const string& engine,
+                                    const Digraph& digraph )
+{
+	if( engine == "pr" ) return new MaxflowT<Cap>( digraph );
+	if( engine == "bk" ) return new BKMaxflowT<Cap>( digraph );
+	return NULL;
+}
+
+template <class Cap>
+MinCutT<Cap>* MinCutT<Cap>::create( const string& engine, int n, int m,
+                                    const pair<u_int, u_int> *arcs )
+{
+	if( engine == "pr" ) return new MaxflowT<Cap>( n, m, arcs );
+	if( engine == "bk" ) return new BKMaxflowT<Cap>( n, m, arcs );
+	return NULL;
+}
+
+template class MinCutT<double>;
+template class MinCutT<int32_t>;
@@ -0,0 +1,94 @@
+/* Maximal flow / minimal cut - common interface of the algorithms */
+
+#ifndef MINCUT_H
+#define MINCUT_H
+
+#include <utility>
+#include <vector>
+#include <string>
+#include <limits>
+#include <stdint.h>
+
+#ifndef FLOW_ROUND_EPS
+#define FLOW_ROUND_EPS 0.0001
+#endif
+
+#ifndef DEFICIT_EPS
+#define DEFICIT_EPS 1e-12
+#endif
+
+#ifndef RESIDUAL_EPS
+#define RESIDUAL_EPS 1e-9
+#endif
+
+using namespace std;
+typedef unsigned int u_int;
+
+class Digraph;
+
+// the excess of the source (unlimited), an excess left at a node which is
+// only a rounding error, a missing flow too small to be sent back by
+// update( changes ), and the largest residual capacity of a saturated arc
+// (the same for all algorithms, so that they find the same cuts); integer
+// capacities are exact
+template <class Cap> struct CapTraits;
+
+template <> struct CapTraits<double>
+{
+	static double biggest() { return numeric_limits<long>::max(); }
+	static double round_eps() { return FLOW_ROUND_EPS; }
+	static double deficit_eps() { return DEFICIT_EPS; }
+	static double residual_eps() { return RESIDUAL_EPS; }
+};
+
+template <> struct CapTraits<int32_t>
+{
+	static int32_t biggest() { return numeric_limits<int32_t>::max(); }
+	static int32_t round_eps() { return 0; }
+	static int32_t deficit_eps() { return 0; }
+	static int32_t residual_eps() { return 0; }
+};
+
+// maximum flow from a source to a target node with capacities of type Cap,
+// implemented by MaxflowT (push-relabel) and BKMaxflowT (Boykov-Kolmogorov);
+// see MaxflowT for the meaning of the methods
+template <class Cap>
+class MinCutT
+{
+
+public:
+
+	virtual ~MinCutT() {}
+
+	// capacities in the same order as the arcs passed to the constructor
+	virtual void update( int s, int t, const Cap *capacities ) = 0;
+	// change source / target nodes without changing capacities
+	virtual void update( int s, int t ) = 0;
+	// change the capacities of some arcs (index, new capacity), starting
+	// from the current flow
+	virtual void update( const vector<pair<int, Cap> >& changes ) = 0;
+
+	// value of the maximum flow; cut[i] is 1 for the nodes reachable from
+	// the source, 2 for those reaching the target in the residual graph
+	// and 0 for the others, if the value is below <border> (else all 0)
+	virtual Cap min_cut( Cap border, int* cut ) = 0;
+
+	// the algorithm <engine> ("pr": push-relabel, "bk": Boykov-Kolmogorov)
+	// on the arcs of the digraph or on an array of m arcs; NULL for an
+	// unknown name
+	static MinCutT* create( const string& engine, const Digraph& digraph );
+	static MinCutT* create( const string& engine, int n, int m,
+	                        const pair<u_int, u_int> *arcs );
+
+	// true if <engine> is a valid name for create()
+	static bool known( const string& engine )
+	{
+		return engine == "pr" || engine == "bk";
+	}
+
+};
+
+typedef MinCutT<double> MinCut;
+typedef MinCutT<int32_t> IntMinCut;
+
+#endif /* MINCUT_H */
@@ -0,0 +1,147 @@
+#include "MinCutSweep.h"
+#include "Digraph.h"
+
+// residual capacities below this are treated as 0
+#define SWEEP_EPS 1e-9
+
+MinCutSweep::MinCutSweep( int n, int m, list<pair<u_int, u_int> >& arcs ) :
+	n( n ), m( m ), tail( m ), head( m ), cap( m, 0 ), flow( m, 0 ),
+	first( n + 1, 0 ), edges( 2 * m ), source( n, 0 ), sink( -1 ),
+	value( 0 ), pred( n, -2 ), queue( n )
+{
+	list<pair<u_int, u_int> >::iterator li = arcs.begin();
+	for( int i = 0; i < m; i++, li++ ) {
+		tail[i] = li->first;
+		head[i] = li->second;
+	}
+	build();
+}
+
+MinCutSweep::MinCutSweep( const Digraph& digraph ) :
+	n( digraph.n_nodes ), m( digraph.n_arcs ), tail( m ), head( m ),
+	cap( m, 0 ), flow( m, 0 ), first( n + 1, 0 ), edges( 2 * m ),
+	source( n, 0 ), sink( -1 ), value( 0 ), pred( n, -2 ), queue( n )
+{
+	for( int i = 0; i < m; i++ ) {
+		tail[i] = digraph.arcs[i].v1;
+		head[i] = digraph.arcs[i].v2;
+	}
+	build();
+}
+
+void MinCutSweep::build()
+{
+	for( int i = 0; i < m; i++ ) {
+		if( tail[i] == head[i] ) continue; // omit self-loops
+		first[tail[i] + 1]++;
+		first[head[i] + 1]++;
+	}
+	for( int v = 0; v < n; v++ ) {
+		first[v + 1] += first[v];
+	}
+	vector<int> pos( first.begin(), first.end() - 1 );
+	for( int i = 0; i < m; i++ ) {
+		if( tail[i] == head[i] ) continue;
+		edges[pos[tail[i]]++] = 2 * i;
+		edges[pos[head[i]]++] = 2 * i + 1;
+	}
+}
+
+void MinCutSweep::init( int s, const double *capacities )
+{
+	for( int i = 0; i < m; i++ ) {
+		cap[i] = capacities[i];
+		flow[i] = 0;
+	}
+	source.assign( n, 0 );
+	source[s] = 1;
+	sink = -1;
+	value = 0;
+}
+
+void MinCutSweep::raise( int arc, double capacity )
+{
+	if( capacity > cap[arc] ) cap[arc] = capacity;
+}
+
+void MinCutSweep::merge( int t )
+{
+	source[t] = 1;
+	sink = -1;
+}
+
+double MinCutSweep::augment( double limit )
+{
+	// breadth first search from all sources
+	int q_read = 0, q_write = 0;
+	for( int v = 0; v < n; v++ ) {
+		if( source[v] ) {
+			pred[v] = -1;
+			queue[q_write++] = v;
+		}
+		else {
+			pred[v] = -2;
+		}
+	}
+	while( q_read < q_write && pred[sink] == -2 ) {
+		int v = queue[q_read++];
+		for( int j = first[v]; j < first[v + 1]; j++ ) {
+			int e = edges[j];
+			int w = target( e );
+			if( pred[w] == -2 && residual( e ) > SWEEP_EPS ) {
+				pred[w] = e;
+				queue[q_write++] = w;
+			}
+		}
+	}
+	if( pred[sink] == -2 ) return 0;
+
+	// bottleneck of the path, then augment
+	double delta = limit;
+	for( int v = sink; pred[v] >= 0; v = target( pred[v] ^ 1 ) ) {
+		if( residual( pred[v] ) < delta ) delta = residual( pred[v] );
+	}
+	for( int v = sink; pred[v] >= 0; v = target( pred[v] ^ 1 ) ) {
+		int e = pred[v];
+		if( e & 1 ) flow[e >> 1] -= delta;
+		else flow[e >> 1] += delta;
+	}
+	return delta;
+}
+
+double MinCutSweep::min_cut( int t, double border, int *cut )
+{
+	if( t != sink ) {
+		sink = t;
+		value = 0;
+	}
+	while( value < border ) {
+		double delta = augment( border - value );
+		if( delta <= 0 ) break;
+		value += delta;
+	}
+	if( value >= border ) return value;
+
+	// the last search reached exactly the source side of the first
+	// minimal cut
+	for( int v = 0; v < n; v++ ) {
+		cut[v] = ( pred[v] != -2 ) ? 1 : 0;
+	}
+	// nodes which can reach the sink in the residual graph
+	int q_read = 0, q_write = 0;
+	queue[q_write++] = sink;
+	cut[sink] = 2;
+	while( q_read < q_write ) {
+		int v = queue[q_read++];
+		for( int j = first[v]; j < first[v + 1]; j++ ) {
+			int e = edges[j];
+			int w = target( e );
+			// residual edge from w to v
+			if( cut[w] == 0 && residual( e ^ 1 ) > SWEEP_EPS ) {
+				cut[w] = 2;
+				queue[q_write++] = w;
+			}
+		}
+	}
+	return value;
+}
@@ -0,0 +1,91 @@
+#ifndef MINCUTSWEEP_H_
+#define MINCUTSWEEP_H_
+
+#include <utility>
+#include <list>
+#include <vector>
+
+using namespace std;
+typedef unsigned int u_int;
+
+class Digraph;
+
+// minimal cuts from one source to a sequence of sinks on the same arcs and
+// capacities, in the style of Hao and Orlin: after a sink is done it is
+// merged into the set of sources, and the flow found so far is kept - it is
+// still a valid flow from the (larger) source set, so every sink only adds
+// the flow which reaches it, found by augmenting paths from all sources.
+//
+// If the sinks are processed in order of decreasing demand (z in the DCC
+// separation) and a sink t has a flow of at least its demand, any cut with
+// t on the sink side has at least this capacity - so merging t into the
+// sources loses no cut violated for a later sink (with a smaller demand).
+class MinCutSweep
+{
+
+public:
+
+	// n = #nodes, m = #arcs, like Maxflow
+	MinCutSweep( int n, int m, list<pair<u_int, u_int> >& arcs );
+	// the arcs of the digraph (with their index in digraph.arcs)
+	MinCutSweep( const Digraph& digraph );
+
+	// start a new sweep from source <s>, capacities are given in the order
+	// of the arcs passed to the constructor
+	void init( int s, const double *capacities );
+
+	// flow from the sources to <t> (added to the flow found by earlier
+	// calls with the same t), augmented only up to <border>;
+	// if it is below <border> the cut is computed like Maxflow::min_cut:
+	//    1 if node i is on source side of the first minimal cut
+	//    2 if node i is on target side of the last minimal cut
+	//    0 otherwise
+	double min_cut( int t, double border, int *cut );
+
+	// increase the capacity of an arc (e.g. to saturate the arcs of a cut)
+	void raise( int arc, double capacity );
+
+	// add node t to the sources
+	void merge( int t );
+
+private:
+
+	int n; // #nodes
+	int m; // #arcs
+
+	vector<int> tail, head; // of each arc
+	vector<double> cap, flow; // of each arc
+
+	// residual edges of node v: edges[first[v]] ... edges[first[v+1]-1],
+	// edge 2*i is arc i forwards, 2*i+1 is arc i backwards
+	vector<int> first, edges;
+
+	vector<char> source; // nodes in the set of sources
+	int sink; // current sink (-1 if none)
+	double value; // flow into the current sink
+
+	// breadth first search: edge a node was reached by (-1 for sources,
+	// -2 if not reached)
+	vector<int> pred;
+	vector<int> queue;
+
+	// fill first/edges from tail/head
+	void build();
+
+	double residual( int e ) const
+	{
+		return ( e & 1 ) ? flow[e >> 1] : cap[e >> 1] - flow[e >> 1];
+	}
+
+	int target( int e ) const
+	{
+		return ( e & 1 ) ? tail[e >> 1] : head[e >> 1];
+	}
+
+	// augment along a shortest path from the sources to the sink by at most
+	// <limit>, returns the amount (0 if there is no path)
+	double augment( double limit );
+
+};
+
+#endif /* MINCUTSWEEP_H_ */
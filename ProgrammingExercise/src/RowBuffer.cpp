@@ -0,0 +1,56 @@
+#include "RowBuffer.h"
+
+void RowBuffer::append( const RowBuffer& other )
+{
+    int offset = rmatind.size();
+    for ( u_int r = 0; r < other.size(); r++ ) {
+        rmatbeg.push_back( other.rmatbeg[r] + offset );
+    }
+    rhs.insert( rhs.end(), other.rhs.begin(), other.rhs.end() );
+    sense.insert( sense.end(), other.sense.begin(), other.sense.end() );
+    rmatind.insert( rmatind.end(), other.rmatind.begin(), other.rmatind.end() );
+    rmatval.insert( rmatval.end(), other.rmatval.begin(), other.rmatval.end() );
+}
+
+void RowBuffer::clear()
+{
+    vector<double>().swap( rhs );
+    vector<char>().swap( sense );
+    vector<int>().swap( rmatbeg );
+    vector<int>().swap( rmatind );
+    vector<double>().swap( rmatval );
+}
+
+IloRangeArray RowBuffer::extract( IloEnv env, IloModel model,
+                                  const IloNumVarArray& cols ) const
+{
+    IloInt count = size();
+    IloNumArray lbs( env, count );
+    IloNumArray ubs( env, count );
+    for ( IloInt r = 0; r < count; r++ ) {
+        lbs[r] = ( sense[r] == 'L' ) ? -IloInfinity : rhs[r];
+        ubs[r] = ( sense[r] == 'G' ) ? IloInfinity : rhs[r];
+    }
+    IloRangeArray ranges( env, lbs, ubs );
+
+    // scratch arrays, reused for all rows
+    IloNumVarArray vars( env );
+    IloNumArray vals( env );
+    for ( IloInt r = 0; r < count; r++ ) {
+        int end = ( r + 1 < count ) ? rmatbeg[r + 1] : (int) rmatind.size();
+        vars.clear();
+        vals.clear();
+        for ( int i = rmatbeg[r]; i < end; i++ ) {
+            vars.add( cols[rmatind[i]] );
+            vals.add( rmatval[i] );
+        }
+        ranges[r].setLinearCoefs( vars, vals );
+    }
+    model.add( ranges );
+
+    vars.end();
+    vals.end();
+    lbs.end();
+    ubs.end();
+    return ranges;
+}
@@ -0,0 +1,62 @@
+#ifndef __ROWBUFFER__H__
+#define __ROWBUFFER__H__
+
+#include "Tools.h"
+#include <vector>
+#include <ilcplex/ilocplex.h>
+
+using namespace std;
+
+// linear rows collected in CSR form (as rmatbeg/rmatind/rmatval of the
+// CPLEX callable library) without creating any Concert objects;
+// columns are referred to by their index in the array passed to extract()
+class RowBuffer
+{
+
+public:
+
+    // right-hand sides and senses ('L' for <=, 'G' for >=, 'E' for =)
+    vector<double> rhs;
+    vector<char> sense;
+    // row r has the coefficients rmatval[rmatbeg[r]] ... up to rmatbeg[r+1]
+    // (exclusive; the last row ends at rmatind.size())
+    vector<int> rmatbeg;
+    vector<int> rmatind;
+    vector<double> rmatval;
+
+    // start a new row, its terms are given by addTerm()
+    void addRow( char _sense, double _rhs )
+    {
+        rmatbeg.push_back( rmatind.size() );
+        sense.push_back( _sense );
+        rhs.push_back( _rhs );
+    }
+
+    // add a term to the last row
+    void addTerm( int col, double val )
+    {
+        rmatind.push_back( col );
+        rmatval.push_back( val );
+    }
+
+    u_int size() const
+    {
+        return rhs.size();
+    }
+
+    // append all rows of <other>
+    void append( const RowBuffer& other );
+
+    // remove all rows and release the memory
+    void clear();
+
+    // create all rows as ranges over <cols> and add them to <model>
+    // with a single model.add(); Concert has no call taking the
+    // coefficients of several rows, so these are set row by row (one
+    // setLinearCoefs() each); returns the ranges in the order of the rows
+    IloRangeArray extract( IloEnv env, IloModel model,
+                           const IloNumVarArray& cols ) const;
+
+};
+
+#endif //__ROWBUFFER__H__
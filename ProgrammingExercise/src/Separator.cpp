@@ -0,0 +1,1108 @@
+#include "Separator.h"
+#include <set>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+Separator::Separator( IloEnv _env, string _cut_type, double _eps,
+                      Digraph& _digraph, IloBoolVarArray& _x,
+                      IloBoolVarArray& _z, u_int _k, bool _cut_early,
+                      u_int _max_cuts, SeparationStats* _stats ) :
+    env( _env ), cut_type( _cut_type ), eps( _eps ), digraph( _digraph ),
+        x( _x ), z( _z ), k( _k ), cut_early( _cut_early ),
+        max_cuts(_max_cuts), fractional( false ), sweep( false ),
+        stats( _stats ), pool( NULL ), recorder( NULL ), seed( 1 ), rng( 1 ),
+        workers( 1 ), worker_pool( NULL ), last_cuts( false ),
+        tail_threshold( 0 ), tail_rounds( 0 ), node( -1 ), objective( 0 ),
+        tail_node( -1 ), tail_objective( 0 ), flat_rounds( 0 ),
+        arc_weights( 2 * digraph.n_edges ), engine( "pr" ), mflow( NULL ),
+        mincut( NULL ),
+        xval( _env, _x.getSize() ), zval( _env, _z.getSize() )
+{
+}
+
+Separator::Separator( const Separator& other ) :
+    env( other.env ), cut_type( other.cut_type ), eps( other.eps ),
+        digraph( other.digraph ), x( other.x ), z( other.z ), k( other.k ),
+        cut_early( other.cut_early ), max_cuts( other.max_cuts ),
+        fractional( other.fractional ), sweep( other.sweep ),
+        stats( other.stats ), pool( other.pool ),
+        recorder( other.recorder ), seed( other.seed ),
+        rng( other.seed ), workers( other.workers ), worker_pool( NULL ),
+        last_cuts( false ), tail_threshold( other.tail_threshold ),
+        tail_rounds( other.tail_rounds ), node( -1 ), objective( 0 ),
+        tail_node( -1 ), tail_objective( 0 ), flat_rounds( 0 ),
+        arc_weights( other.arc_weights.size() ), engine( other.engine ),
+        mflow( NULL ), mincut( NULL ),
+        xval( other.env, other.x.getSize() ),
+        zval( other.env, other.z.getSize() )
+{
+}
+
+Separator::~Separator()
+{
+    delete mflow;
+    for ( u_int w = 0; w < int_flows.size(); w++ ) {
+        delete int_flows[w];
+    }
+    delete mincut;
+    delete worker_pool;
+    xval.end();
+    zval.end();
+}
+
+void Separator::separate( bool lazy, IloRangeArray& cuts )
+{
+    double time = Tools::wallTime();
+    IloInt before = cuts.getSize();
+    if ( !lazy ) {
+        bool tailing = tailingOff();
+        // a point without cuts in the last call has none now either
+        bool repeated = !tailing && samePoint() && !last_cuts;
+        if ( tailing || repeated ) {
+            if ( stats != NULL ) {
+                stats->skip( repeated ? 1 : 0, tailing ? 1 : 0, 0 );
+                stats->add( 1, 0, 0, Tools::wallTime() - time );
+            }
+            return;
+        }
+        if ( recorder != NULL && cut_type == "dcc" ) {
+            recorder->record( xval, zval, eps );
+        }
+    }
+    // cuts of the pool violated by this solution make the separation
+    // unnecessary
+    if ( pool != NULL ) {
+        pooled.clear();
+        pool->check( xval, zval, eps, pooled );
+        for ( u_int c = 0; c < pooled.size() && c < max_cuts; c++ ) {
+            cuts.add( toRange( pooled[c] ) );
+        }
+    }
+    if( cuts.getSize() == before ) {
+        if( lazy && cut_type == "dcc" ) integerConnectionCuts( cuts );
+        else if( lazy ) integerCycleCuts( cuts );
+        else if( cut_type == "gsec" ) subtourEliminationCuts( cuts );
+        else if( cut_type == "dcc" && fractional && sweep ) sweepConnectionCuts( cuts );
+        else if( cut_type == "dcc" && fractional ) fractionalConnectionCuts( cuts );
+        else if( cut_type == "dcc" ) connectionCuts( lazy, cuts );
+        else if( cut_type == "cec" ) cycleEliminationCuts( cuts );
+    }
+    if ( !lazy ) {
+        last_cuts = cuts.getSize() > before;
+    }
+    if ( stats != NULL ) {
+        stats->add( 1, cuts.getSize() - before, 0,
+                    Tools::wallTime() - time );
+    }
+}
+
+bool Separator::samePoint()
+{
+    vector<pair<u_int, double> > point;
+    u_int nx = xval.getSize();
+    for ( u_int i = 0; i < nx; i++ ) {
+        if ( xval[i] > eps ) {
+            point.push_back( make_pair( i, (double) xval[i] ) );
+        }
+    }
+    for ( u_int v = 0; v < (u_int) zval.getSize(); v++ ) {
+        if ( zval[v] > eps ) {
+            point.push_back( make_pair( nx + v, (double) zval[v] ) );
+        }
+    }
+    bool same_support = point.size() == last_point.size() &&
+                        clean.size() == digraph.n_nodes;
+    for ( u_int j = 0; same_support && j < point.size(); j++ ) {
+        same_support = point[j].first == last_point[j].first;
+    }
+    if ( !same_support ) {
+        clean.assign( digraph.n_nodes, 0 );
+    }
+    bool same = same_support && point == last_point;
+    last_point.swap( point );
+    return same;
+}
+
+bool Separator::tailingOff()
+{
+    if ( tail_rounds == 0 ) {
+        return false;
+    }
+    if ( node != tail_node ) {
+        tail_node = node;
+        flat_rounds = 0;
+    }
+    else if ( objective - tail_objective <
+              tail_threshold * max( 1.0, fabs( objective ) ) ) {
+        flat_rounds++;
+    }
+    else {
+        flat_rounds = 0;
+    }
+    tail_objective = objective;
+    return flat_rounds >= tail_rounds;
+}
+
+IloRange Separator::toRange( const CutPool::Cut& inequality )
+{
+    IloExpr constraint( env );
+    for ( u_int j = 0; j < inequality.xs.size(); j++ ) {
+        constraint += x[inequality.xs[j]];
+    }
+    for ( u_int j = 0; j < inequality.zs.size(); j++ ) {
+        constraint -= z[inequality.zs[j]];
+    }
+    IloRange range = ( inequality.sense == 'G' ) ?
+        ( constraint >= inequality.rhs ) : ( constraint <= inequality.rhs );
+    constraint.end();
+    return range;
+}
+
+void Separator::addCut( CutPool::Cut& inequality, IloRangeArray& cuts )
+{
+    cuts.add( toRange( inequality ) );
+    if ( pool != NULL ) {
+        pool->add( inequality );
+    }
+}
+
+vector<u_int> Separator::byValue( const IloNumArray& values, u_int from,
+                                  u_int to )
+{
+    vector<u_int> order;
+    for ( u_int i = from; i < to; i++ ) {
+        if ( values[i] > eps ) {
+            order.push_back( i );
+        }
+    }
+    shuffle( order.begin(), order.end(), rng );
+    stable_sort( order.begin(), order.end(),
+                 [&values]( u_int i, u_int j ) {
+                     return values[i] > values[j];
+                 } );
+    return order;
+}
+
+/*
+ * add the max_cuts candidates with the largest violation divided by the
+ * norm of their coefficients (all 1 or -1), each distinct cut once (e.g.
+ * connectionCuts() finds the same cut for all nodes not reachable from the
+ * root)
+ */
+void Separator::selectCuts( IloRangeArray& cuts )
+{
+    vector<pair<double, u_int> > order;
+    for ( u_int c = 0; c < candidates.size(); c++ ) {
+        CutPool::Cut& inequality = candidates[c];
+        double lhs = CutPool::activity( inequality, xval, zval );
+        double violation = ( inequality.sense == 'G' ) ?
+            inequality.rhs - lhs : lhs - inequality.rhs;
+        double terms = inequality.xs.size() + inequality.zs.size();
+        order.push_back( pair<double, u_int>( -violation / sqrt( terms ),
+                                              c ) );
+    }
+    sort( order.begin(), order.end() );
+    set<pair<vector<u_int>, vector<u_int> > > added;
+    for ( u_int j = 0; j < order.size() && added.size() < max_cuts; j++ ) {
+        CutPool::Cut& inequality = candidates[order[j].second];
+        sort( inequality.xs.begin(), inequality.xs.end() );
+        sort( inequality.zs.begin(), inequality.zs.end() );
+        if ( added.insert( make_pair( inequality.xs, inequality.zs ) ).second ) {
+            addCut( inequality, cuts );
+        }
+    }
+    candidates.clear();
+}
+
+void Separator::parallel( u_int count,
+                          const function<void( u_int, u_int )>& task )
+{
+    if ( worker_pool == NULL ) {
+        worker_pool = new WorkerPool( workers );
+    }
+    worker_pool->run( count, task );
+}
+
+/*
+ * the arcs never change, so the MaxFlow algorithm is initialized only in
+ * the first round; later rounds only set new capacities
+ */
+void Separator::initMaxflow()
+{
+    if ( mflow != NULL ) {
+        return;
+    }
+    u_int n = digraph.n_nodes;
+    u_int a = digraph.n_arcs;
+    if ( cut_type == "gsec" ) {
+        // both directions of each edge, then s -> v and v -> t for each
+        // node v, with s = n and t = n + 1
+        u_int m = digraph.n_edges;
+        vector<pair<u_int, u_int> > arcs;
+        arcs.reserve( 2 * m + 2 * n );
+        for ( u_int i = 0; i < m; i++ ) {
+            u_int v1 = digraph.edges[i].v1;
+            u_int v2 = digraph.edges[i].v2;
+            arcs.push_back(pair<u_int, u_int>( v1, v2 ));
+        }
+        for ( u_int i = 0; i < m; i++ ) {
+            u_int v1 = digraph.edges[i].v1;
+            u_int v2 = digraph.edges[i].v2;
+            arcs.push_back(pair<u_int, u_int>( v2, v1 ));
+        }
+        for ( u_int v = 0; v < n; v++ ) {
+            arcs.push_back(pair<u_int, u_int>( n, v ));
+        }
+        for ( u_int v = 0; v < n; v++ ) {
+            arcs.push_back(pair<u_int, u_int>( v, n + 1 ));
+        }
+        a = 2 * m + 2 * n;
+        n += 2;
+        mflow = MinCut::create( engine, n, a, &arcs[0] );
+    }
+    else {
+        mflow = MinCut::create( engine, digraph );
+    }
+    capacity.resize( a );
+    cut.resize( n );
+    if ( stats != NULL ) {
+        stats->add( 0, 0, 1, 0 );
+    }
+}
+
+void Separator::initIntMaxflow( u_int count )
+{
+    if ( int_flows.size() >= count ) {
+        return;
+    }
+    int_capacity.resize( digraph.n_arcs );
+    int_loaded.resize( count );
+    int_values.resize( batchSize() );
+    int_cuts.assign( batchSize(), vector<int>( digraph.n_nodes ) );
+    while ( int_flows.size() < count ) {
+        int_flows.push_back( IntMinCut::create( engine, digraph ) );
+        if ( stats != NULL ) {
+            stats->add( 0, 0, 1, 0 );
+        }
+    }
+}
+
+/*
+ * separation of directed connection cut inequalities
+ */
+void Separator::connectionCuts( bool lazy, IloRangeArray& cuts )
+{
+    if ( !lazy && !cut_early ) {
+        // if not specified by the user, do not cut early
+        return;
+    }
+    try {
+
+        u_int n = digraph.n_nodes;
+        u_int a = digraph.n_arcs;
+
+        initIntMaxflow( workers );
+
+        // initialize arc capacities with x
+        for ( u_int i = 0; i < a; i++ ) {
+            // we count capacity if the arc is used, 0 if not
+            int_capacity[i] = xval[i] > eps ? 1 : 0;
+        }
+        int_loaded.assign( workers, 0 );
+
+        // we look for minimum capacity cut < 1 for the nodes != 0 used in
+        // the current solution, by decreasing z
+        vector<u_int> order = byValue( zval, 1, n );
+        // keep count of all involved nodes in cuts so far
+        set<u_int> used_nodes;
+        // the nodes of a batch
+        u_int batch = batchSize();
+        vector<u_int> targets;
+        // nodes skipped as clean (see samePoint())
+        unsigned long memoized = 0;
+        bool done = false;
+        for ( u_int start = 0; start < order.size() && !done;
+              start += batch ) {
+            targets.clear();
+            for ( u_int j = start; j < order.size() && j < start + batch;
+                  j++ ) {
+                if ( clean[order[j]] ) {
+                    memoized++;
+                }
+                else if ( used_nodes.find( order[j] ) == used_nodes.end() ) {
+                    targets.push_back( order[j] );
+                }
+            }
+            parallel( targets.size(), [&]( u_int worker, u_int t ) {
+                IntMinCut* flow = int_flows[worker];
+                if ( int_loaded[worker] ) {
+                    flow->update( 0, targets[t] );
+                }
+                else {
+                    flow->update( 0, targets[t], &int_capacity[0] );
+                    int_loaded[worker] = 1;
+                }
+                int_values[t] = flow->min_cut( 1, &int_cuts[t][0] );
+            } );
+            // merged in the order of the nodes, a node may be used by a cut
+            // of an earlier one in the same batch
+            for ( u_int t = 0; t < targets.size() && !done; t++ ) {
+                if ( used_nodes.find( targets[t] ) != used_nodes.end() ) {
+                    continue;
+                }
+                if ( int_values[t] >= 1 ) {
+                    clean[targets[t]] = 1;
+                    continue;
+                }
+                vector<int>& side = int_cuts[t];
+                // we found a cut which might violate the DCC constraint
+                // we have to count the number of nodes on the left side -
+                // they must be less or equal than k
+                u_int count = 0;
+                for ( u_int i = 0; i < n; i++ ) {
+                    if ( side[i] == 1 ) count++;
+                }
+                // did we find one with less than k nodes?
+                if ( count <= k ) {
+                    // add the new nodes to the set of used ones
+                    for ( u_int i = 0; i < n; i++ ) {
+                        if ( side[i] == 1 ) {
+                            used_nodes.insert( i );
+                        }
+                    }
+                    CutPool::Cut inequality;
+                    for ( u_int j = 0; j < a; j++ ) {
+                        u_int v1 = digraph.arcs[j].v1;
+                        u_int v2 = digraph.arcs[j].v2;
+                        if ( side[v1] == 1 && side[v2] != 1 ) {
+                            inequality.xs.push_back( j );
+                        }
+                    }
+                    inequality.sense = 'G';
+                    inequality.rhs = 1;
+                    candidates.push_back( inequality );
+                    // check if we should look for more cuts
+                    done = candidates.size() >= maxCandidates();
+                }
+                else {
+                    clean[targets[t]] = 1;
+                }
+            }
+        }
+        selectCuts( cuts );
+        if ( stats != NULL ) {
+            stats->skip( 0, 0, memoized );
+        }
+    }
+    catch( IloException& e ) {
+        cerr << "Separator: exception " << e.getMessage();
+        exit( -1 );
+    }
+    catch( ... ) {
+        cerr << "Separator: unknown exception.\n";
+        exit( -1 );
+    }
+}
+
+/*
+ * separation of directed connection cut inequalities with fractional
+ * capacities
+ */
+void Separator::fractionalConnectionCuts( IloRangeArray& cuts )
+{
+    // upper limit for the nested cuts of one node
+    const u_int max_nested = 20;
+    try {
+
+        u_int n = digraph.n_nodes;
+        u_int a = digraph.n_arcs;
+
+        initMaxflow();
+
+        // the values of x as capacities
+        for ( u_int i = 0; i < a; i++ ) {
+            capacity[i] = xval[i] > eps ? xval[i] : 0;
+        }
+
+        // nodes on the sink side of a cut found so far
+        vector<bool> covered( n, false );
+        // the target nodes by decreasing z
+        vector<u_int> order = byValue( zval, 1, n );
+        // arcs saturated for nested cuts (to be reset for the next node),
+        // those of the last cut as changes for the maximum flow
+        vector<u_int> saturated;
+        vector<pair<int, double> > changes;
+        // mflow has the capacities (no saturated arcs)
+        bool loaded = false;
+        for ( u_int j = 0; j < order.size() &&
+                           candidates.size() < maxCandidates(); j++ ) {
+            u_int i = order[j];
+            if ( covered[i] ) {
+                continue;
+            }
+            for ( u_int nested = 0; nested < max_nested; nested++ ) {
+                if ( nested > 0 ) {
+                    // raised capacities: the flow for the last cut is
+                    // still feasible, only augment it
+                    mflow->update( changes );
+                    changes.clear();
+                }
+                else if ( loaded ) {
+                    mflow->update( 0, i );
+                }
+                else {
+                    mflow->update( 0, i, &capacity[0] );
+                    loaded = true;
+                }
+                // the cut is only computed if the flow is below z(i)
+                if ( mflow->min_cut( zval[i] - eps, &cut[0] ) >=
+                     zval[i] - eps ) {
+                    break;
+                }
+                addConnectionCut( i, false );
+                addConnectionCut( i, true );
+                // saturate the arcs of the cut, the next cut is behind them
+                for ( u_int e = 0; e < a; e++ ) {
+                    u_int v1 = digraph.arcs[e].v1;
+                    u_int v2 = digraph.arcs[e].v2;
+                    if ( cut[v1] == 1 && cut[v2] != 1 && capacity[e] < 1 ) {
+                        capacity[e] = 1;
+                        saturated.push_back( e );
+                        changes.push_back( pair<int, double>( e, 1 ) );
+                    }
+                }
+                for ( u_int v = 0; v < n; v++ ) {
+                    if ( cut[v] == 2 ) {
+                        covered[v] = true;
+                    }
+                }
+            }
+            for ( u_int e = 0; e < saturated.size(); e++ ) {
+                u_int arc = saturated[e];
+                capacity[arc] = xval[arc] > eps ? xval[arc] : 0;
+            }
+            if ( !saturated.empty() ) {
+                loaded = false;
+            }
+            saturated.clear();
+            changes.clear();
+        }
+        selectCuts( cuts );
+    }
+    catch( IloException& e ) {
+        cerr << "Separator: exception " << e.getMessage();
+        exit( -1 );
+    }
+    catch( ... ) {
+        cerr << "Separator: unknown exception.\n";
+        exit( -1 );
+    }
+}
+
+/*
+ * separation of directed connection cut inequalities with fractional
+ * capacities in one sweep
+ */
+void Separator::sweepConnectionCuts( IloRangeArray& cuts )
+{
+    // upper limit for the nested cuts of one node
+    const u_int max_nested = 20;
+    try {
+
+        u_int n = digraph.n_nodes;
+        u_int a = digraph.n_arcs;
+
+        if ( mincut == NULL ) {
+            mincut = new MinCutSweep( digraph );
+            capacity.resize( a );
+            cut.resize( n );
+        }
+
+        // the values of x as capacities
+        for ( u_int i = 0; i < a; i++ ) {
+            capacity[i] = xval[i] > eps ? xval[i] : 0;
+        }
+        mincut->init( 0, &capacity[0] );
+
+        // selected nodes in order of decreasing z
+        vector<pair<double, u_int> > order;
+        for ( u_int i = 1; i < n; i++ ) {
+            if ( zval[i] > eps ) {
+                order.push_back( pair<double, u_int>( -zval[i], i ) );
+            }
+        }
+        sort( order.begin(), order.end() );
+
+        for ( u_int j = 0; j < order.size() &&
+                           candidates.size() < maxCandidates(); j++ ) {
+            u_int i = order[j].second;
+            for ( u_int nested = 0; nested < max_nested; nested++ ) {
+                if ( mincut->min_cut( i, zval[i] - eps, &cut[0] ) >=
+                     zval[i] - eps ) {
+                    break;
+                }
+                addConnectionCut( i, false );
+                addConnectionCut( i, true );
+                // saturate the arcs of the cut, the next cut is behind them
+                for ( u_int e = 0; e < a; e++ ) {
+                    u_int v1 = digraph.arcs[e].v1;
+                    u_int v2 = digraph.arcs[e].v2;
+                    if ( cut[v1] == 1 && cut[v2] != 1 ) {
+                        mincut->raise( e, 1 );
+                    }
+                }
+            }
+            mincut->merge( i );
+        }
+        selectCuts( cuts );
+    }
+    catch( IloException& e ) {
+        cerr << "Separator: exception " << e.getMessage();
+        exit( -1 );
+    }
+    catch( ... ) {
+        cerr << "Separator: unknown exception.\n";
+        exit( -1 );
+    }
+}
+
+bool Separator::addConnectionCut( u_int i, bool back )
+{
+    // the first minimal cut has the source side S = { v: cut[v] == 1 },
+    // the last one (back cut) S = { v: cut[v] != 2 }; both are the same if
+    // no node has cut[v] == 0
+    if ( back ) {
+        bool same = true;
+        for ( u_int v = 0; v < digraph.n_nodes && same; v++ ) {
+            same = ( cut[v] != 0 );
+        }
+        if ( same ) {
+            return false;
+        }
+    }
+    CutPool::Cut inequality;
+    for ( u_int j = 0; j < digraph.n_arcs; j++ ) {
+        int c1 = cut[digraph.arcs[j].v1];
+        int c2 = cut[digraph.arcs[j].v2];
+        bool source1 = back ? c1 != 2 : c1 == 1;
+        bool source2 = back ? c2 != 2 : c2 == 1;
+        if ( source1 && !source2 ) {
+            inequality.xs.push_back( j );
+        }
+    }
+    if ( inequality.xs.empty() ) {
+        return false;
+    }
+    inequality.zs.push_back( i );
+    inequality.sense = 'G';
+    inequality.rhs = 0;
+    candidates.push_back( inequality );
+    return true;
+}
+
+/*
+ * directed connection cuts for an integer solution: the nodes reachable
+ * from the root on arcs with x = 1 are found by breadth first search, then
+ * each (weakly connected) component of the remaining arcs with x = 1 which
+ * contains a node i with z(i) = 1 gives the violated cut x(delta-(C)) >= z(i)
+ */
+void Separator::integerConnectionCuts( IloRangeArray& cuts )
+{
+    try {
+
+        u_int n = digraph.n_nodes;
+
+        // component of each node: 0 if reachable from the root, -1 if not
+        // labeled yet
+        vector<int> comp( n, -1 );
+        vector<u_int> queue( n );
+        u_int q_read = 0, q_write = 0;
+        comp[0] = 0;
+        queue[q_write++] = 0;
+        while ( q_read < q_write ) {
+            u_int v = queue[q_read++];
+            for ( u_int j = digraph.outStart[v]; j < digraph.outStart[v+1];
+                  j++ ) {
+                u_int arc = digraph.outArc[j];
+                u_int w = digraph.arcs[arc].v2;
+                if ( xval[arc] > 0.5 && comp[w] == -1 ) {
+                    comp[w] = 0;
+                    queue[q_write++] = w;
+                }
+            }
+        }
+
+        u_int cut_count = 0;
+        for ( u_int i = 1; i < n && cut_count < max_cuts; i++ ) {
+            if ( comp[i] != -1 || zval[i] <= 0.5 ) {
+                continue;
+            }
+            // the component C of node i, in both directions of the arcs
+            int label = cut_count + 1;
+            q_read = q_write = 0;
+            comp[i] = label;
+            queue[q_write++] = i;
+            while ( q_read < q_write ) {
+                u_int v = queue[q_read++];
+                for ( u_int j = digraph.outStart[v];
+                      j < digraph.outStart[v+1]; j++ ) {
+                    u_int arc = digraph.outArc[j];
+                    u_int w = digraph.arcs[arc].v2;
+                    if ( xval[arc] > 0.5 && comp[w] == -1 ) {
+                        comp[w] = label;
+                        queue[q_write++] = w;
+                    }
+                }
+                for ( u_int j = digraph.inStart[v];
+                      j < digraph.inStart[v+1]; j++ ) {
+                    u_int arc = digraph.inArc[j];
+                    u_int w = digraph.arcs[arc].v1;
+                    if ( xval[arc] > 0.5 && comp[w] == -1 ) {
+                        comp[w] = label;
+                        queue[q_write++] = w;
+                    }
+                }
+            }
+            // no arc with x = 1 enters C
+            CutPool::Cut inequality;
+            for ( u_int q = 0; q < q_write; q++ ) {
+                u_int v = queue[q];
+                for ( u_int j = digraph.inStart[v];
+                      j < digraph.inStart[v+1]; j++ ) {
+                    u_int arc = digraph.inArc[j];
+                    if ( comp[digraph.arcs[arc].v1] != label ) {
+                        inequality.xs.push_back( arc );
+                    }
+                }
+            }
+            inequality.zs.push_back( i );
+            inequality.sense = 'G';
+            inequality.rhs = 0;
+            addCut( inequality, cuts );
+            cut_count++;
+        }
+    }
+    catch( IloException& e ) {
+        cerr << "Separator: exception " << e.getMessage();
+        exit( -1 );
+    }
+    catch( ... ) {
+        cerr << "Separator: unknown exception.\n";
+        exit( -1 );
+    }
+}
+
+/*
+ * cycle elimination cuts for an integer solution: a spanning forest of the
+ * edges with x = 1 is built by breadth first search, each other edge with
+ * x = 1 closes a cycle with the path between its end nodes in the forest
+ */
+void Separator::integerCycleCuts( IloRangeArray& cuts )
+{
+    try {
+
+        u_int n = digraph.n_nodes;
+        u_int m = digraph.n_edges;
+
+        // edge to the parent in the forest (-1 for the roots) and depth
+        // (-1 if not reached yet) of each node
+        vector<int> parent( n, -1 );
+        vector<int> depth( n, -1 );
+        vector<u_int> queue( n );
+        for ( u_int r = 0; r < n; r++ ) {
+            if ( depth[r] != -1 ) {
+                continue;
+            }
+            u_int q_read = 0, q_write = 0;
+            depth[r] = 0;
+            queue[q_write++] = r;
+            while ( q_read < q_write ) {
+                u_int v = queue[q_read++];
+                for ( u_int j = digraph.adjStart[v];
+                      j < digraph.adjStart[v+1]; j++ ) {
+                    u_int e = digraph.adjEdge[j];
+                    u_int u = digraph.adjNode[j];
+                    if ( xval[e] > 0.5 && depth[u] == -1 ) {
+                        depth[u] = depth[v] + 1;
+                        parent[u] = e;
+                        queue[q_write++] = u;
+                    }
+                }
+            }
+        }
+
+        u_int cut_count = 0;
+        for ( u_int e = 0; e < m && cut_count < max_cuts; e++ ) {
+            u_int v1 = digraph.edges[e].v1;
+            u_int v2 = digraph.edges[e].v2;
+            if ( xval[e] <= 0.5 || parent[v1] == (int) e ||
+                 parent[v2] == (int) e ) {
+                continue;
+            }
+            // walk up from the deeper end node until both paths meet
+            CutPool::Cut inequality;
+            inequality.xs.push_back( e );
+            while ( v1 != v2 ) {
+                if ( depth[v1] < depth[v2] ) {
+                    swap( v1, v2 );
+                }
+                u_int f = parent[v1];
+                inequality.xs.push_back( f );
+                v1 = ( digraph.edges[f].v1 == v1 ) ? digraph.edges[f].v2 :
+                                                     digraph.edges[f].v1;
+            }
+            inequality.sense = 'L';
+            inequality.rhs = inequality.xs.size() - 1;
+            addCut( inequality, cuts );
+            cut_count++;
+        }
+    }
+    catch( IloException& e ) {
+        cerr << "Separator: exception " << e.getMessage();
+        exit( -1 );
+    }
+    catch( ... ) {
+        cerr << "Separator: unknown exception.\n";
+        exit( -1 );
+    }
+}
+
+/*
+ * separation of cycle elimination cut inequalities
+ */
+void Separator::cycleEliminationCuts( IloRangeArray& cuts )
+{
+    try {
+
+        u_int m = digraph.n_edges;
+
+        // initialize arc weights: 1 - x
+        for ( u_int i = 0; i < m; i++ ) {
+            arc_weights[i] = 1 - xval[i];
+            arc_weights[i+m] = 1 - xval[i];
+        }
+        // an edge with x <= eps alone has a weight >= 1 - eps, so the
+        // cycles are searched in the support graph only
+        initSupport();
+
+        // we look for cycles closed by the edges of the support graph, by
+        // decreasing x
+        vector<u_int> order = byValue( xval, 0, m );
+        set<u_int> used_edges;
+        // the edges of a batch with their shortest paths
+        u_int batch = batchSize();
+        vector<u_int> targets;
+        vector<SPResultT> paths( batch );
+        bool done = false;
+        for ( u_int start = 0; start < order.size() && !done;
+              start += batch ) {
+            targets.clear();
+            for ( u_int j = start; j < order.size() && j < start + batch;
+                  j++ ) {
+                if ( used_edges.find( order[j] ) == used_edges.end() ) {
+                    targets.push_back( order[j] );
+                }
+            }
+            // calculate shortest path from v1 to v2 without the edge,
+            // only as long as the cycle can be violated
+            parallel( targets.size(), [&]( u_int worker, u_int t ) {
+                u_int i1 = targets[t];
+                paths[t] = shortestPath( sp_work[worker],
+                                         digraph.edges[i1].v1,
+                                         digraph.edges[i1].v2, i1,
+                                         1 - eps - arc_weights[i1] );
+            } );
+            // merged in the order of the edges, an edge may be used by a
+            // cycle of an earlier one in the same batch
+            for ( u_int t = 0; t < targets.size() && !done; t++ ) {
+                // did we use the edge already?
+                u_int i1 = targets[t];
+                if ( used_edges.find( i1 ) != used_edges.end() ) {
+                    continue;
+                }
+                SPResultT& spResult = paths[t];
+                double compareValue = spResult.weight + arc_weights[i1];
+                int spSize = spResult.path.size();
+                if (spSize >= 1 && compareValue < 1 - eps) {
+                    // we found a new constraint to add!
+                    CutPool::Cut inequality;
+                    list<u_int>::iterator it;
+                    for ( it = spResult.path.begin();
+                          it != spResult.path.end();
+                          ++it ) {
+                        u_int e = *it;
+                        if ( e >= m ) {
+                            e -= m;
+                        }
+                        used_edges.insert(e);
+                        inequality.xs.push_back( e );
+                    }
+                    // add edge i1
+                    used_edges.insert(i1);
+                    inequality.xs.push_back( i1 );
+                    inequality.sense = 'L';
+                    inequality.rhs = spSize;
+                    candidates.push_back( inequality );
+                    // check if we shall look for more cuts to add
+                    done = candidates.size() >= maxCandidates();
+                }
+            }
+        }
+        selectCuts( cuts );
+    }
+    catch( IloException& e ) {
+        cerr << "Separator: exception " << e.getMessage();
+        exit( -1 );
+    }
+    catch( ... ) {
+        cerr << "Separator: unknown exception.\n";
+        exit( -1 );
+    }
+}
+
+/*
+ * separation of generalized subtour elimination cut inequalities
+ *
+ * With d(v) = x(delta(v)) we have 2 x(E(S)) = d(S) - x(delta(S)), so
+ *   x(E(S)) - z(S) = - ( x(delta(S))/2 + sum_{v in S} (z(v) - d(v)/2) ).
+ * In a network with the edges as arcs in both directions with capacity
+ * x/2, an arc v -> t with capacity z(v) - d(v)/2 if this is positive, an arc
+ * s -> v with capacity d(v)/2 - z(v) otherwise, a cut ({s} + S, ...) has
+ * the capacity x(delta(S))/2 + sum_{v in S} (z(v) - d(v)/2) + N, N the sum
+ * of the capacities of all arcs leaving s. With j forced into S (an arc
+ * s -> j of large capacity), the inequality for j is violated if the
+ * minimal cut is below N + z(j).
+ */
+void Separator::subtourEliminationCuts( IloRangeArray& cuts )
+{
+    try {
+
+        u_int n = digraph.n_nodes;
+        u_int m = digraph.n_edges;
+        u_int s = n;
+        u_int t = n + 1;
+
+        initMaxflow();
+
+        vector<double> degree( n, 0 );
+        for ( u_int i = 0; i < m; i++ ) {
+            double value = xval[i] > eps ? xval[i] : 0;
+            capacity[i] = value / 2;
+            capacity[i+m] = value / 2;
+            degree[digraph.edges[i].v1] += value;
+            degree[digraph.edges[i].v2] += value;
+        }
+        double total = 0;
+        double infinite = 1;
+        for ( u_int v = 0; v < n; v++ ) {
+            double balance = zval[v] - degree[v] / 2;
+            capacity[2*m+v] = balance < 0 ? -balance : 0;
+            capacity[2*m+n+v] = balance > 0 ? balance : 0;
+            total += capacity[2*m+v];
+            infinite += capacity[2*m+v] + capacity[2*m+n+v];
+        }
+        for ( u_int i = 0; i < 2 * m; i++ ) {
+            infinite += capacity[i];
+        }
+
+        // nodes in a violated set S found so far
+        vector<bool> covered( n, false );
+        // nodes j by decreasing z
+        vector<u_int> order = byValue( zval, 0, n );
+        for ( u_int o = 0; o < order.size() &&
+                           candidates.size() < maxCandidates(); o++ ) {
+            u_int j = order[o];
+            if ( covered[j] ) {
+                continue;
+            }
+            double old = capacity[2*m+j];
+            capacity[2*m+j] = infinite;
+            mflow->update( s, t, &capacity[0] );
+            double border = total + zval[j] - eps;
+            double min_cut = mflow->min_cut( border, &cut[0] );
+            capacity[2*m+j] = old;
+            if ( min_cut >= border ) {
+                continue;
+            }
+            // S: the nodes on the source side of the cut
+            CutPool::Cut inequality;
+            for ( u_int i = 0; i < m; i++ ) {
+                if ( cut[digraph.edges[i].v1] == 1 &&
+                     cut[digraph.edges[i].v2] == 1 ) {
+                    inequality.xs.push_back( i );
+                }
+            }
+            for ( u_int v = 0; v < n; v++ ) {
+                if ( cut[v] == 1 ) {
+                    covered[v] = true;
+                    if ( v != j ) {
+                        inequality.zs.push_back( v );
+                    }
+                }
+            }
+            inequality.sense = 'L';
+            inequality.rhs = 0;
+            candidates.push_back( inequality );
+        }
+        selectCuts( cuts );
+    }
+    catch( IloException& e ) {
+        cerr << "Separator: exception " << e.getMessage();
+        exit( -1 );
+    }
+    catch( ... ) {
+        cerr << "Separator: unknown exception.\n";
+        exit( -1 );
+    }
+}
+
+/*
+ * adjacency of the support graph (edges with x > eps) for shortestPath()
+ */
+void Separator::initSupport()
+{
+    u_int n = digraph.n_nodes;
+    u_int m = digraph.n_edges;
+    supStart.assign( n + 1, 0 );
+    for( u_int e = 0; e < m; e++ ) {
+        if( xval[e] > eps ) {
+            supStart[digraph.edges[e].v1 + 1]++;
+            supStart[digraph.edges[e].v2 + 1]++;
+        }
+    }
+    for( u_int v = 0; v < n; v++ ) {
+        supStart[v+1] += supStart[v];
+    }
+    supNode.resize( supStart[n] );
+    supArc.resize( supStart[n] );
+    vector<u_int> pos( supStart.begin(), supStart.end() - 1 );
+    for( u_int e = 0; e < m; e++ ) {
+        if( xval[e] > eps ) {
+            u_int v1 = digraph.edges[e].v1;
+            u_int v2 = digraph.edges[e].v2;
+            supNode[pos[v1]] = v2;
+            supArc[pos[v1]++] = e;
+            supNode[pos[v2]] = v1;
+            supArc[pos[v2]++] = e + m;
+        }
+    }
+    // the workspaces of shortestPath() are kept between the calls
+    sp_work.resize( workers );
+    for( u_int w = 0; w < workers; w++ ) {
+        if( sp_work[w].dist.size() != n ) {
+            sp_work[w].dist.assign( n, numeric_limits<double>::max() );
+            sp_work[w].pred.assign( n, -1 );
+            sp_work[w].heap_pos.assign( n, -1 );
+        }
+    }
+}
+
+void Separator::SPWorkspace::up( u_int i )
+{
+    u_int v = heap[i];
+    while( i > 0 ) {
+        u_int p = ( i - 1 ) / 2;
+        if( dist[heap[p]] <= dist[v] ) break;
+        heap[i] = heap[p];
+        heap_pos[heap[i]] = i;
+        i = p;
+    }
+    heap[i] = v;
+    heap_pos[v] = i;
+}
+
+void Separator::SPWorkspace::down( u_int i )
+{
+    u_int v = heap[i];
+    u_int size = heap.size();
+    while( 2 * i + 1 < size ) {
+        u_int c = 2 * i + 1;
+        if( c + 1 < size && dist[heap[c+1]] < dist[heap[c]] ) c++;
+        if( dist[v] <= dist[heap[c]] ) break;
+        heap[i] = heap[c];
+        heap_pos[heap[i]] = i;
+        i = c;
+    }
+    heap[i] = v;
+    heap_pos[v] = i;
+}
+
+/*
+ * Dijkstra's algorithm to find a shortest path, with a binary heap on the
+ * support graph (initSupport() has to be called before)
+ */
+Separator::SPResultT Separator::shortestPath( SPWorkspace& work,
+                                              u_int source, u_int target,
+                                              u_int excluded, double bound )
+{
+    u_int m = digraph.n_edges;
+    vector<u_int>& reached = work.reached;
+
+    SPResultT sp;
+    sp.weight = 0;
+    if( bound <= 0 ) return sp;
+
+    work.dist[source] = 0;
+    reached.push_back( source );
+    work.heap.push_back( source );
+    work.heap_pos[source] = 0;
+
+    while( !work.heap.empty() ) {
+
+        // unfinished node with minimum weight, finished now (position -2)
+        u_int v = work.heap[0];
+        work.heap_pos[v] = -2;
+        u_int last = work.heap.back();
+        work.heap.pop_back();
+        if( !work.heap.empty() ) {
+            work.heap[0] = last;
+            work.down( 0 );
+        }
+
+        // target node is reached -> stop
+        if( v == target ) break;
+
+        // update all adjacent nodes on outgoing arcs
+        for( u_int i = supStart[v]; i < supStart[v+1]; i++ ) {
+            u_int a = supArc[i];
+            u_int u = supNode[i];
+            if( a == excluded || a == excluded + m ) continue;
+            // only examine adjacent node if unfinished, and only paths
+            // shorter than bound
+            double weight = work.dist[v] + arc_weights[a];
+            if( work.heap_pos[u] == -2 || weight >= bound ||
+                weight >= work.dist[u] ) continue;
+            if( work.dist[u] == numeric_limits<double>::max() ) {
+                reached.push_back( u );
+            }
+            work.dist[u] = weight;
+            work.pred[u] = a;
+            if( work.heap_pos[u] < 0 ) {
+                work.heap_pos[u] = work.heap.size();
+                work.heap.push_back( u );
+            }
+            work.up( work.heap_pos[u] );
+        }
+    }
+
+    if( work.pred[target] >= 0 ) {
+        u_int v = target;
+        while( v != source ) {
+            u_int a = work.pred[v];
+            sp.weight += arc_weights[a];
+            sp.path.push_back( a );
+            v = ( a < m ) ? digraph.edges[a].v1 : digraph.edges[a-m].v2;
+        }
+    }
+
+    // reset the workspace
+    for( u_int j = 0; j < reached.size(); j++ ) {
+        work.dist[reached[j]] = numeric_limits<double>::max();
+        work.pred[reached[j]] = -1;
+        work.heap_pos[reached[j]] = -1;
+    }
+    reached.clear();
+    work.heap.clear();
+    return sp;
+}
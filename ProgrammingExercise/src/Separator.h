@@ -0,0 +1,402 @@
+#ifndef SEPARATOR_H_
+#define SEPARATOR_H_
+
+#include "Digraph.h"
+#include "MinCut.h"
+#include "MinCutSweep.h"
+#include "CutPool.h"
+#include "WorkerPool.h"
+#include <ilcplex/ilocplex.h>
+#include <mutex>
+#include <random>
+#include <fstream>
+
+using namespace std;
+
+// counters of all separators of a solve
+struct SeparationStats
+{
+    mutex lock;
+    unsigned long calls; // calls of Separator::separate()
+    unsigned long cuts; // inequalities found
+    unsigned long maxflows; // Maxflow instances built
+    double time; // wall time spent in Separator::separate()
+    unsigned long repeated; // calls skipped for a repeated point
+    unsigned long tailed; // calls skipped for tailing off
+    unsigned long memoized; // targets skipped as known without violated cut
+
+    SeparationStats() :
+        calls( 0 ), cuts( 0 ), maxflows( 0 ), time( 0 ), repeated( 0 ),
+        tailed( 0 ), memoized( 0 )
+    {
+    }
+
+    void add( unsigned long _calls, unsigned long _cuts,
+              unsigned long _maxflows, double _time )
+    {
+        unique_lock<mutex> guard( lock );
+        calls += _calls;
+        cuts += _cuts;
+        maxflows += _maxflows;
+        time += _time;
+    }
+
+    void skip( unsigned long _repeated, unsigned long _tailed,
+               unsigned long _memoized )
+    {
+        unique_lock<mutex> guard( lock );
+        repeated += _repeated;
+        tailed += _tailed;
+        memoized += _memoized;
+    }
+
+    void reset()
+    {
+        unique_lock<mutex> guard( lock );
+        calls = cuts = maxflows = 0;
+        repeated = tailed = memoized = 0;
+        time = 0;
+    }
+};
+
+// the fractional points separated for dcc, written to a file for replaying
+// them (see bench_replay), one line per point with the support of x and z:
+// "x <count> <arc> <value> ... z <count> <node> <value> ..."
+struct SeparationRecorder
+{
+    mutex lock;
+    ofstream out;
+
+    SeparationRecorder( const string& file ) : out( file.c_str() )
+    {
+        out.precision( 17 );
+    }
+
+    void record( const IloNumArray& xval, const IloNumArray& zval,
+                 double eps )
+    {
+        unique_lock<mutex> guard( lock );
+        const IloNumArray* values[] = { &xval, &zval };
+        for ( u_int v = 0; v < 2; v++ ) {
+            const IloNumArray& val = *values[v];
+            u_int count = 0;
+            for ( IloInt i = 0; i < val.getSize(); i++ ) {
+                if ( val[i] > eps ) count++;
+            }
+            out << ( v == 0 ? "x " : " z " ) << count;
+            for ( IloInt i = 0; i < val.getSize(); i++ ) {
+                if ( val[i] > eps ) out << " " << i << " " << val[i];
+            }
+        }
+        out << "\n";
+    }
+};
+
+// separation of cycle elimination cuts ("cec"), generalized subtour
+// elimination cuts ("gsec") and directed connection cuts ("dcc"),
+// independent of the callback API of CPLEX;
+// a separator is used by one thread at a time - a copy has the same
+// settings but its own workspace
+class Separator
+{
+
+private:
+
+    IloEnv env;
+    string cut_type;
+    double eps;
+    Digraph& digraph;
+    IloBoolVarArray x;
+    IloBoolVarArray z;
+    u_int k;
+    bool cut_early;
+    u_int max_cuts;
+    // dcc: fractional capacities, lifted, nested and back cuts
+    bool fractional;
+    // dcc with fractional: use the MinCutSweep instead of one Maxflow per
+    // node
+    bool sweep;
+    // counters (shared by all copies, may be NULL)
+    SeparationStats* stats;
+    // cuts found so far (shared by all copies, may be NULL)
+    CutPool* pool;
+    vector<CutPool::Cut> pooled;
+    // dcc: records the fractional points (shared by all copies, may be
+    // NULL)
+    SeparationRecorder* recorder;
+
+    // the cut as a range on x and z
+    IloRange toRange( const CutPool::Cut& inequality );
+    // add the cut to <cuts> and to the pool
+    void addCut( CutPool::Cut& inequality, IloRangeArray& cuts );
+
+    // random order of candidates with the same value (see setSeed())
+    unsigned int seed;
+    mt19937 rng;
+    // the indices from ... to-1 with a value > eps, by decreasing value
+    // (equal values in random order)
+    vector<u_int> byValue( const IloNumArray& values, u_int from, u_int to );
+    // violated cuts collected by the separation methods for fractional
+    // points, about maxCandidates() of them; only the max_cuts most
+    // violated (relative to their number of terms) are added by
+    // selectCuts()
+    vector<CutPool::Cut> candidates;
+    u_int maxCandidates() const
+    {
+        // 4 * max_cuts, clamped for a huge -n
+        return max_cuts < numeric_limits<u_int>::max() / 4 ?
+            4 * max_cuts : numeric_limits<u_int>::max();
+    }
+    void selectCuts( IloRangeArray& cuts );
+
+    // threads for the independent maximum flows of connectionCuts() and
+    // shortest paths of cycleEliminationCuts(), created in the first call
+    u_int workers;
+    WorkerPool* worker_pool;
+    // candidates evaluated in parallel before merging the results
+    u_int batchSize() const
+    {
+        return workers > 1 ? 4 * workers : 1;
+    }
+    // run task( worker, i ) for i = 0 ... count-1 on the workers
+    void parallel( u_int count, const function<void( u_int, u_int )>& task );
+
+    // the last fractional point: indices (z after x) of its support with
+    // their values, and whether cuts were found for it; separating the
+    // same point again cannot find cuts if there were none
+    vector<pair<u_int, double> > last_point;
+    bool last_cuts;
+    // connectionCuts() only depends on the support: the nodes without a
+    // violated cut for the support of last_point
+    vector<char> clean;
+    // true if (xval, zval) is last_point, which is updated
+    bool samePoint();
+
+    // tailing off (see setTailingOff()) with the node and objective of the
+    // relaxation set by setRelaxation(), the objective of the last call and
+    // the number of calls in a row with too little improvement
+    double tail_threshold;
+    u_int tail_rounds;
+    long node;
+    double objective;
+    long tail_node;
+    double tail_objective;
+    u_int flat_rounds;
+    bool tailingOff();
+
+    // separate directed connection cuts
+    void connectionCuts( bool lazy, IloRangeArray& cuts );
+
+    // separate directed connection cuts x(delta+(S)) >= z(i) with the
+    // values of x as capacities
+    void fractionalConnectionCuts( IloRangeArray& cuts );
+
+    // the same with a single sweep over the nodes in order of decreasing
+    // z(i), see MinCutSweep
+    void sweepConnectionCuts( IloRangeArray& cuts );
+
+    // add the cut x(delta+(S)) >= z(i) to the candidates, S are the nodes
+    // with cut[v] == 1 (back: cut[v] != 2); returns false if the arc set
+    // is empty
+    bool addConnectionCut( u_int i, bool back );
+
+    // separate cycle elimination cuts
+    void cycleEliminationCuts( IloRangeArray& cuts );
+
+    // separate generalized subtour elimination cuts x(E(S)) <= z(S) - z(j)
+    // exactly, with one maximum flow for each node j
+    void subtourEliminationCuts( IloRangeArray& cuts );
+
+    // integer solutions (lazy constraints): in time O(n+m), one directed
+    // connection cut for each component of the solution not reachable
+    // from the root, one cycle elimination cut for each cycle closed by an
+    // edge not in a spanning forest of the solution
+    void integerConnectionCuts( IloRangeArray& cuts );
+    void integerCycleCuts( IloRangeArray& cuts );
+
+    // result of shortest path computation
+    struct SPResultT
+    {
+        list<u_int> path;
+        double weight;
+    };
+    // arc weights for shortest path computation
+    // (should be set according to current LP solution)
+    vector<double> arc_weights;
+    // support graph: the edges with x > eps, adjacency of node v in
+    // supNode/supArc[supStart[v]] ... [supStart[v+1]-1]
+    vector<u_int> supStart;
+    vector<u_int> supNode;
+    vector<u_int> supArc;
+    void initSupport();
+    // workspace of shortestPath(), one for each worker: distance and arc to
+    // the predecessor (-1 if none) of each node, binary heap of nodes with
+    // the position of each node in it (-1 if not in the heap)
+    struct SPWorkspace
+    {
+        vector<double> dist;
+        vector<int> pred;
+        vector<u_int> heap;
+        vector<int> heap_pos;
+        // nodes with a distance set, to reset the workspace afterwards
+        vector<u_int> reached;
+        void up( u_int i );
+        void down( u_int i );
+    };
+    vector<SPWorkspace> sp_work;
+    // computes a shortest path from source to target according to arc_weights
+    // in the support graph without edge <excluded>:
+    //    number of edges: m -> number of arcs: 2*m
+    //    edge (v1,v2) with id <i> -> arc (v1,v2) with id <i>,
+    //                                arc (v2,v1) with id <i+m>
+    // only paths shorter than <bound> are searched
+    // (returns list of arc ids of a shortest path and the according weight,
+    // an empty path if there is none shorter than bound)
+    SPResultT shortestPath( SPWorkspace& work, u_int source, u_int target,
+                            u_int excluded, double bound );
+
+    // maximum flow algorithm (see MinCut::create())
+    string engine;
+    // maximum flow on the arcs of the digraph (for gsec: on the network of
+    // subtourEliminationCuts()), built in the first call and reused with
+    // new capacities in later calls
+    MinCut* mflow;
+    vector<double> capacity;
+    vector<int> cut;
+    void initMaxflow();
+    // connectionCuts() has 0/1 capacities: exact integer maximum flows, one
+    // instance for each worker
+    vector<IntMinCut*> int_flows;
+    vector<int32_t> int_capacity;
+    // per worker: capacities set in its instance in this call; per node of
+    // a batch: value and cut of its minimal flow
+    vector<char> int_loaded;
+    vector<int32_t> int_values;
+    vector<vector<int> > int_cuts;
+    void initIntMaxflow( u_int count );
+    // likewise for the sweep
+    MinCutSweep* mincut;
+
+public:
+
+    // values of x and z in the solution to separate, to be set by the
+    // callback before calling separate()
+    IloNumArray xval;
+    IloNumArray zval;
+
+    Separator( IloEnv _env, string _cut_type, double _eps,
+               Digraph& _digraph, IloBoolVarArray& _x,
+               IloBoolVarArray& _z, u_int _k, bool _cut_early,
+               u_int _max_cuts, SeparationStats* _stats = NULL );
+    Separator( const Separator& other );
+    ~Separator();
+
+    IloBoolVarArray& getX()
+    {
+        return x;
+    }
+
+    IloBoolVarArray& getZ()
+    {
+        return z;
+    }
+
+    // number of nodes to connect (changed between the solves of a k-sweep)
+    void setK( u_int _k )
+    {
+        k = _k;
+        last_point.clear();
+        clean.clear();
+    }
+
+    // dcc: separate with the fractional values as capacities; the cuts are
+    // lifted to >= z(i), and nested cuts (the arcs of a cut saturated, then
+    // separated again) as well as back cuts (from the sink side) are
+    // candidates for selectCuts()
+    void setFractional( bool _fractional )
+    {
+        fractional = _fractional;
+    }
+
+    // find the fractional cuts with one sweep (MinCutSweep) instead of one
+    // maximum flow per node; this finds a violated cut whenever there is
+    // one, but not necessarily one for every node with a violated cut
+    void setSweep( bool _sweep )
+    {
+        sweep = _sweep;
+    }
+
+    // check the cuts of <_pool> before separating, and add all cuts found
+    // to it
+    void setPool( CutPool* _pool )
+    {
+        pool = _pool;
+    }
+
+    // dcc: write each fractional point separated to <_recorder>
+    void setRecorder( SeparationRecorder* _recorder )
+    {
+        recorder = _recorder;
+    }
+
+    // threads used within one call of separate(); the results are merged
+    // in the same order as without threads, so the cuts do not depend on
+    // the number of threads
+    void setWorkers( u_int _workers )
+    {
+        workers = _workers > 0 ? _workers : 1;
+    }
+
+    // stop separating the fractional points of a node once the objective
+    // of the relaxation improved by less than <threshold> (relative) in
+    // <rounds> calls in a row (0: never)
+    void setTailingOff( double threshold, u_int rounds )
+    {
+        tail_threshold = threshold;
+        tail_rounds = rounds;
+    }
+
+    // node (any id unique during its cutting loop) and objective of the
+    // relaxation, to be set by the callback before separating a fractional
+    // point when tailing off is used
+    void setRelaxation( long _node, double _objective )
+    {
+        node = _node;
+        objective = _objective;
+    }
+
+    // maximum flow algorithm: "pr" (push-relabel, default) or "bk"
+    // (Boykov-Kolmogorov), see MinCut::create()
+    void setEngine( const string& _engine )
+    {
+        engine = _engine;
+    }
+
+    // seed for the order of candidates with the same value
+    void setSeed( unsigned int _seed )
+    {
+        seed = _seed;
+        rng.seed( seed );
+    }
+
+    // true if cuts are also separated for fractional solutions (dcc: with
+    // -c or with fractional capacities)
+    bool separatesFractional() const
+    {
+        return cut_type == "cec" || cut_type == "gsec" || cut_early ||
+               ( cut_type == "dcc" && fractional );
+    }
+
+    // add violated inequalities for the solution (xval, zval) to <cuts>,
+    // with <lazy> set for integer solutions (which are separated in linear
+    // time, without maximum flows or shortest paths); the caller has to
+    // end() them
+    void separate( bool lazy, IloRangeArray& cuts );
+
+private:
+
+    Separator& operator=( const Separator& other );
+
+};
+
+#endif /* SEPARATOR_H_ */
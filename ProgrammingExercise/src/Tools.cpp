@@ -2,6 +2,10 @@
 #define __TOOLS__CPP__
 
 #include "Tools.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <cstring>
 
 string Tools::indicesToString( string prefix, int i, int j, int v )
 {
@@ -21,4 +25,83 @@ double Tools::CPUtime()
 	return t.tms_utime / ct;
 }
 
+double Tools::wallTime()
+{
+	timeval t;
+	gettimeofday( &t, NULL );
+	return t.tv_sec + t.tv_usec / 1e6;
+}
+
+double Tools::peakMemory()
+{
+	rusage r;
+	getrusage( RUSAGE_SELF, &r );
+#ifdef __APPLE__
+	return r.ru_maxrss / ( 1024.0 * 1024.0 ); // bytes
+#else
+	return r.ru_maxrss / 1024.0; // kilobytes
+#endif
+}
+
+unsigned long long Tools::checksum( const void* data, size_t size )
+{
+	const unsigned long long prime = 1099511628211ULL;
+	unsigned long long h = 14695981039346656037ULL;
+	const unsigned char *p = (const unsigned char*) data;
+	size_t i = 0;
+	for( ; i + 8 <= size; i += 8 ) {
+		unsigned long long w;
+		memcpy( &w, p + i, 8 );
+		h = ( h ^ w ) * prime;
+	}
+	for( ; i < size; i++ ) {
+		h = ( h ^ p[i] ) * prime;
+	}
+	return h;
+}
+
+Tools::MappedFile::MappedFile() :
+	begin( NULL ), length( 0 )
+{
+}
+
+Tools::MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool Tools::MappedFile::open( const string& file )
+{
+	close();
+	int fd = ::open( file.c_str(), O_RDONLY );
+	if( fd < 0 ) return false;
+	struct stat st;
+	if( fstat( fd, &st ) != 0 ) {
+		::close( fd );
+		return false;
+	}
+	length = st.st_size;
+	if( length > 0 ) {
+		void *p = mmap( NULL, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( p == MAP_FAILED ) {
+			::close( fd );
+			length = 0;
+			return false;
+		}
+		// the file is read front to back exactly once
+		madvise( p, length, MADV_SEQUENTIAL );
+		begin = (const char*) p;
+	}
+	// the mapping stays valid after the descriptor is closed
+	::close( fd );
+	return true;
+}
+
+void Tools::MappedFile::close()
+{
+	if( begin ) munmap( (void*) begin, length );
+	begin = NULL;
+	length = 0;
+}
+
 #endif // __TOOLS__CPP__
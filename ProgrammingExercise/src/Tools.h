@@ -13,6 +13,8 @@
 #include <algorithm>
 #include <iomanip>
 #include <sys/times.h>
+#include <sys/time.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
 using namespace std;
@@ -23,6 +25,39 @@ namespace Tools
 	string indicesToString( string prefix, int i, int j = -1, int v = -1 );
 	// measure running time
 	double CPUtime();
+	// measure elapsed (wall clock) time
+	double wallTime();
+	// peak resident memory of the process in MB
+	double peakMemory();
+	// 64-bit FNV-1a style checksum, processing 8 bytes per step
+	unsigned long long checksum( const void* data, size_t size );
+
+	// read-only memory mapping of a whole file
+	class MappedFile
+	{
+
+	public:
+
+		MappedFile();
+		~MappedFile();
+
+		// map the file, returns false if it cannot be opened or mapped
+		bool open( const string& file );
+		void close();
+
+		const char* data() const { return begin; }
+		size_t size() const { return length; }
+
+	private:
+
+		const char* begin;
+		size_t length;
+
+		// prevent compiler from auto-generating these
+		MappedFile( const MappedFile& other );
+		MappedFile& operator=( const MappedFile& other );
+
+	};
 }
 ;
 // Tools
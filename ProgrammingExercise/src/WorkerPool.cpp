@@ -0,0 +1,82 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool( u_int size ) :
+    job( NULL ), job_size( 0 ), next( 0 ), busy( 0 ), generation( 0 ),
+    stop( false )
+{
+    for ( u_int i = 1; i < size; i++ ) {
+        threads.push_back( thread( &WorkerPool::loop, this, i ) );
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        unique_lock<mutex> guard( lock );
+        stop = true;
+    }
+    wake.notify_all();
+    for ( u_int i = 0; i < threads.size(); i++ ) {
+        threads[i].join();
+    }
+}
+
+void WorkerPool::run( u_int count, const function<void( u_int, u_int )>& task )
+{
+    if ( threads.empty() ) {
+        for ( u_int i = 0; i < count; i++ ) {
+            task( 0, i );
+        }
+        return;
+    }
+    {
+        unique_lock<mutex> guard( lock );
+        job = &task;
+        job_size = count;
+        next = 0;
+        busy = threads.size();
+        generation++;
+    }
+    wake.notify_all();
+    work( 0 );
+    unique_lock<mutex> guard( lock );
+    while ( busy > 0 ) {
+        done.wait( guard );
+    }
+    job = NULL;
+}
+
+void WorkerPool::loop( u_int worker )
+{
+    unsigned long seen = 0;
+    while ( true ) {
+        {
+            unique_lock<mutex> guard( lock );
+            while ( !stop && generation == seen ) {
+                wake.wait( guard );
+            }
+            if ( stop ) {
+                return;
+            }
+            seen = generation;
+        }
+        work( worker );
+        {
+            unique_lock<mutex> guard( lock );
+            if ( --busy == 0 ) {
+                done.notify_one();
+            }
+        }
+    }
+}
+
+void WorkerPool::work( u_int worker )
+{
+    while ( true ) {
+        u_int i = next++;
+        if ( i >= job_size ) {
+            break;
+        }
+        ( *job )( worker, i );
+    }
+}
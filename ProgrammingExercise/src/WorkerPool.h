@@ -0,0 +1,62 @@
+#ifndef __WORKERPOOL__H__
+#define __WORKERPOOL__H__
+
+#include "Tools.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+using namespace std;
+
+// a fixed set of worker threads running the tasks 0 ... count-1 of a job;
+// the calling thread takes part as worker 0, so a pool of size 1 runs
+// everything in the calling thread without any synchronization
+class WorkerPool
+{
+
+public:
+
+    WorkerPool( u_int size );
+    ~WorkerPool();
+
+    // number of workers, including the calling thread
+    u_int size() const
+    {
+        return threads.size() + 1;
+    }
+
+    // run task( worker, i ) for i = 0 ... count-1 and wait until all are done;
+    // tasks are handed out in increasing order of i to whichever worker is
+    // free, <worker> (0 ... size()-1) can be used to pick a per-worker
+    // workspace
+    void run( u_int count, const function<void( u_int, u_int )>& task );
+
+private:
+
+    vector<thread> threads;
+
+    mutex lock;
+    condition_variable wake; // a new job is available (or stop is set)
+    condition_variable done; // all workers finished the current job
+
+    // current job
+    const function<void( u_int, u_int )> *job;
+    u_int job_size;
+    atomic<u_int> next; // next task to hand out
+    u_int busy; // number of background workers still working on the job
+    unsigned long generation; // counts the jobs, to detect a new one
+    bool stop;
+
+    void loop( u_int worker );
+    void work( u_int worker );
+
+    // prevent compiler from auto-generating these
+    WorkerPool( const WorkerPool& other );
+    WorkerPool& operator=( const WorkerPool& other );
+
+};
+
+#endif //__WORKERPOOL__H__
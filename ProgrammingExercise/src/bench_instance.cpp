@@ -0,0 +1,156 @@
+// benchmark for loading instances: iostream reference loop vs. mapped parser,
+// and the full Digraph from the text file vs. from its binary cache;
+// also compares neighbour walks over linked incidence lists and CSR arrays
+
+#include "Digraph.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <list>
+
+using namespace std;
+
+// the former ifstream based reader, kept as a reference
+static u_int loadStream( const string& file )
+{
+	ifstream ifs( file.c_str() );
+	u_int n_nodes, n_edges;
+	ifs >> n_nodes >> n_edges;
+	vector<Instance::Edge> edges( n_edges );
+	vector<list<u_int> > incidentEdges( n_nodes );
+	u_int id;
+	while( ifs >> id ) {
+		ifs >> edges[id].v1 >> edges[id].v2 >> edges[id].weight;
+		incidentEdges[edges[id].v1].push_back( id );
+		incidentEdges[edges[id].v2].push_back( id );
+	}
+	return n_edges;
+}
+
+// visit every neighbour of every node <reps> times, using per-node lists
+static double walkLists( const Instance& instance, int reps )
+{
+	vector<list<u_int> > incident( instance.n_nodes );
+	for( u_int i = 0; i < instance.n_edges; i++ ) {
+		incident[instance.edges[i].v1].push_back( i );
+		incident[instance.edges[i].v2].push_back( i );
+	}
+	unsigned long sum = 0;
+	double t0 = Tools::wallTime();
+	for( int r = 0; r < reps; r++ ) {
+		for( u_int v = 0; v < instance.n_nodes; v++ ) {
+			list<u_int>::const_iterator it;
+			for( it = incident[v].begin(); it != incident[v].end(); ++it ) {
+				const Instance::Edge& e = instance.edges[*it];
+				sum += ( e.v1 == v ) ? e.v2 : e.v1;
+			}
+		}
+	}
+	double t = Tools::wallTime() - t0;
+	// keep the loop from being optimized away
+	if( sum == 1 ) cout << "";
+	return t / reps;
+}
+
+// the same walk over the CSR arrays of Instance
+static double walkCSR( const Instance& instance, int reps )
+{
+	unsigned long sum = 0;
+	double t0 = Tools::wallTime();
+	for( int r = 0; r < reps; r++ ) {
+		for( u_int v = 0; v < instance.n_nodes; v++ ) {
+			for( u_int i = instance.adjStart[v]; i < instance.adjStart[v + 1]; i++ ) {
+				sum += instance.adjNode[i];
+			}
+		}
+	}
+	double t = Tools::wallTime() - t0;
+	if( sum == 1 ) cout << "";
+	return t / reps;
+}
+
+// write a random connected instance in the format of data/g*.dat:
+// root node 0 is connected to every other node with weight 0
+static void writeRandom( u_int n, u_int m, const string& file )
+{
+	if( m < 2 * ( n - 1 ) ) m = 2 * ( n - 1 );
+	FILE *f = fopen( file.c_str(), "w" );
+	if( !f ) {
+		cerr << "could not write " << file << endl;
+		exit( 1 );
+	}
+	srand( 4711 );
+	fprintf( f, "%u\n%u\n", n, m );
+	u_int id = 0;
+	for( u_int v = 1; v < n; v++, id++ ) {
+		fprintf( f, "%u 0 %u 0\n", id, v );
+	}
+	// a random spanning path keeps the graph connected
+	for( u_int v = 2; v < n; v++, id++ ) {
+		fprintf( f, "%u %u %u %d\n", id, 1 + rand() % ( v - 1 ), v, 1 + rand() % 1000 );
+	}
+	for( ; id < m; id++ ) {
+		u_int v1 = 1 + rand() % ( n - 1 );
+		u_int v2 = 1 + rand() % ( n - 1 );
+		fprintf( f, "%u %u %u %d\n", id, v1, v2, 1 + rand() % 1000 );
+	}
+	fclose( f );
+}
+
+int main( int argc, char *argv[] )
+{
+	int reps = 5;
+	int i = 1;
+	if( argc < 2 ) {
+		cout << "USAGE:\t" << argv[0] << " [-r reps] [-g nodes edges file] files...\n";
+		return 1;
+	}
+	for( ; i < argc && argv[i][0] == '-'; i++ ) {
+		string opt( argv[i] );
+		if( opt == "-r" && i + 1 < argc ) {
+			reps = atoi( argv[++i] );
+		}
+		else if( opt == "-g" && i + 3 < argc ) {
+			writeRandom( atoi( argv[i + 1] ), atoi( argv[i + 2] ), argv[i + 3] );
+			i += 3;
+		}
+	}
+
+	cout << "file,edges,ifstream[s],mmap[s],digraph text[s],digraph cache[s],"
+		 << "list walk[s],csr walk[s]" << endl;
+	for( ; i < argc; i++ ) {
+		string file( argv[i] );
+		double t0 = Tools::wallTime();
+		u_int m = 0;
+		for( int r = 0; r < reps; r++ ) {
+			m = loadStream( file );
+		}
+		double t1 = Tools::wallTime();
+		for( int r = 0; r < reps; r++ ) {
+			Instance instance( file, true );
+		}
+		double t2 = Tools::wallTime();
+		for( int r = 0; r < reps; r++ ) {
+			Digraph digraph( file, true );
+		}
+		double t3 = Tools::wallTime();
+		{
+			// make sure the cache exists before timing it
+			Digraph digraph( file, true, true );
+		}
+		double t4 = Tools::wallTime();
+		for( int r = 0; r < reps; r++ ) {
+			Digraph digraph( file, true, true );
+		}
+		double t5 = Tools::wallTime();
+		Instance instance( file, true );
+		// walk small graphs often enough to get measurable times
+		int walks = 1 + 20000000 / ( 1 + instance.n_edges );
+		cout << file << "," << m << "," << ( t1 - t0 ) / reps << ","
+			 << ( t2 - t1 ) / reps << "," << ( t3 - t2 ) / reps << ","
+			 << ( t5 - t4 ) / reps << "," << walkLists( instance, walks ) << ","
+			 << walkCSR( instance, walks ) << endl;
+	}
+	return 0;
+}
@@ -0,0 +1,176 @@
+// benchmark for the minimal cuts of the DCC separation: one Maxflow run per
+// selected node vs. a single MinCutSweep over all of them, on random
+// fractional points with a dense support; and one run per node on the 0/1
+// capacities of the support (rounded separation) with double and int32_t
+// capacities
+
+#include "Digraph.h"
+#include "Maxflow.h"
+#include "MinCutSweep.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+// a random fractional point: a share <density> of the arcs gets one of the
+// values 1/4, 1/2, 3/4, 1, every node with such an incoming arc a z of
+// 1/4 ... 1
+static void randomPoint( const Digraph& digraph, double density,
+                         vector<double>& x, vector<double>& z )
+{
+	x.assign( digraph.n_arcs, 0 );
+	z.assign( digraph.n_nodes, 0 );
+	for( u_int i = 0; i < digraph.n_arcs; i++ ) {
+		if( rand() < density * RAND_MAX ) {
+			x[i] = ( 1 + rand() % 4 ) / 4.0;
+			z[digraph.arcs[i].v2] = ( 1 + rand() % 4 ) / 4.0;
+		}
+	}
+}
+
+// nodes i with a minimal cut from the root below z(i) - eps, one Maxflow
+// run each
+static vector<bool> repeated( Maxflow& mflow, const Digraph& digraph,
+                              vector<double>& x, const vector<double>& z,
+                              double eps )
+{
+	vector<bool> violated( digraph.n_nodes, false );
+	vector<int> cut( digraph.n_nodes );
+	bool initialized = false;
+	for( u_int i = 1; i < digraph.n_nodes; i++ ) {
+		if( z[i] <= eps ) continue;
+		if( initialized ) {
+			mflow.update( 0, i );
+		}
+		else {
+			mflow.update( 0, i, &x[0] );
+			initialized = true;
+		}
+		violated[i] = mflow.min_cut( z[i] - eps, &cut[0] ) < z[i] - eps;
+	}
+	return violated;
+}
+
+// the same for the rounded separation: capacity 1 on the support of x, a
+// node is violated if its flow is below 1
+template <class Cap>
+static vector<bool> rounded( MaxflowT<Cap>& mflow, const Digraph& digraph,
+                             const vector<double>& x, const vector<double>& z,
+                             double eps )
+{
+	vector<bool> violated( digraph.n_nodes, false );
+	vector<int> cut( digraph.n_nodes );
+	vector<Cap> support( digraph.n_arcs );
+	for( u_int i = 0; i < digraph.n_arcs; i++ ) {
+		support[i] = x[i] > eps ? 1 : 0;
+	}
+	bool initialized = false;
+	for( u_int i = 1; i < digraph.n_nodes; i++ ) {
+		if( z[i] <= eps ) continue;
+		if( initialized ) {
+			mflow.update( 0, i );
+		}
+		else {
+			mflow.update( 0, i, &support[0] );
+			initialized = true;
+		}
+		violated[i] = mflow.min_cut( 1, &cut[0] ) < 1;
+	}
+	return violated;
+}
+
+// the same with one sweep in order of decreasing z
+static vector<bool> sweep( MinCutSweep& mincut, const Digraph& digraph,
+                           const vector<double>& x, const vector<double>& z,
+                           double eps, u_int& first )
+{
+	vector<bool> violated( digraph.n_nodes, false );
+	vector<int> cut( digraph.n_nodes );
+	vector<pair<double, u_int> > order;
+	for( u_int i = 1; i < digraph.n_nodes; i++ ) {
+		if( z[i] > eps ) order.push_back( pair<double, u_int>( -z[i], i ) );
+	}
+	sort( order.begin(), order.end() );
+	first = 0;
+	mincut.init( 0, &x[0] );
+	for( u_int j = 0; j < order.size(); j++ ) {
+		u_int i = order[j].second;
+		violated[i] = mincut.min_cut( i, z[i] - eps, &cut[0] ) < z[i] - eps;
+		if( violated[i] && first == 0 ) first = i;
+		mincut.merge( i );
+	}
+	return violated;
+}
+
+int main( int argc, char *argv[] )
+{
+	int reps = 10;
+	double density = 0.3;
+	const double eps = 1e-6;
+	int i = 1;
+	if( argc < 2 ) {
+		cout << "USAGE:\t" << argv[0] << " [-r reps] [-d density] files...\n";
+		return 1;
+	}
+	for( ; i < argc && argv[i][0] == '-'; i++ ) {
+		string opt( argv[i] );
+		if( opt == "-r" && i + 1 < argc ) {
+			reps = atoi( argv[++i] );
+		}
+		else if( opt == "-d" && i + 1 < argc ) {
+			density = atof( argv[++i] );
+		}
+	}
+	cout << "file,nodes,arcs,maxflow per node (s),sweep (s),"
+	     << "violated (maxflow),violated (sweep),0/1 double (s),"
+	     << "0/1 int32 (s),violated (0/1),consistent\n";
+	for( ; i < argc; i++ ) {
+		string file( argv[i] );
+		Digraph digraph( file, true );
+		Maxflow mflow( digraph );
+		MinCutSweep mincut( digraph );
+		IntMaxflow iflow( digraph );
+
+		srand( 1 );
+		double t_repeated = 0, t_sweep = 0, t_double = 0, t_int = 0;
+		u_int n_repeated = 0, n_sweep = 0, n_rounded = 0;
+		bool consistent = true;
+		vector<double> x, z;
+		for( int r = 0; r < reps; r++ ) {
+			randomPoint( digraph, density, x, z );
+			double t0 = Tools::wallTime();
+			vector<bool> v1 = repeated( mflow, digraph, x, z, eps );
+			double t1 = Tools::wallTime();
+			u_int first;
+			vector<bool> v2 = sweep( mincut, digraph, x, z, eps, first );
+			double t2 = Tools::wallTime();
+			vector<bool> v3 = rounded( mflow, digraph, x, z, eps );
+			double t3 = Tools::wallTime();
+			vector<bool> v4 = rounded( iflow, digraph, x, z, eps );
+			double t4 = Tools::wallTime();
+			t_repeated += t1 - t0;
+			t_sweep += t2 - t1;
+			t_double += t3 - t2;
+			t_int += t4 - t3;
+			if( v3 != v4 ) consistent = false;
+			// the sweep only reports nodes with a violated cut, and it finds
+			// one if there is one at all
+			bool any = false;
+			for( u_int v = 0; v < digraph.n_nodes; v++ ) {
+				if( v1[v] ) n_repeated++, any = true;
+				if( v2[v] ) n_sweep++;
+				if( v4[v] ) n_rounded++;
+				if( v2[v] && !v1[v] ) consistent = false;
+			}
+			if( any != ( first != 0 ) ) consistent = false;
+		}
+		cout << file << "," << digraph.n_nodes << "," << digraph.n_arcs << ","
+		     << t_repeated / reps << "," << t_sweep / reps << ","
+		     << n_repeated << "," << n_sweep << "," << t_double / reps << ","
+		     << t_int / reps << "," << n_rounded << ","
+		     << ( consistent ? "yes" : "NO" ) << endl;
+	}
+	return 0;
+}
@@ -0,0 +1,209 @@
+// benchmark for the maximum flow algorithms (push-relabel and
+// Boykov-Kolmogorov) and their incremental update: replays the fractional
+// dcc points recorded by kmst -R, with the maximum flows of some target
+// nodes either recomputed for each point or updated with the arcs whose
+// value changed since the point before; and the nested cuts of each point
+// (arcs of a cut saturated, then the flow computed again) both ways
+
+#include "Digraph.h"
+#include "MinCut.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// upper limit for the nested cuts of one node (as in the Separator)
+static const u_int max_nested = 20;
+
+// read the points of <file>, one line "x <count> <arc> <value> ...
+// z <count> <node> <value> ..." each; returns false on a format error
+static bool readPoints( const string& file, const Digraph& digraph,
+                        vector<vector<double> >& xs,
+                        vector<vector<double> >& zs )
+{
+	ifstream in( file.c_str() );
+	string line;
+	while( getline( in, line ) ) {
+		istringstream fields( line );
+		vector<double> x( digraph.n_arcs, 0 ), z( digraph.n_nodes, 0 );
+		for( int v = 0; v < 2; v++ ) {
+			vector<double>& val = v == 0 ? x : z;
+			string name;
+			u_int count;
+			if( !( fields >> name >> count ) ) return false;
+			for( u_int c = 0; c < count; c++ ) {
+				u_int i;
+				double value;
+				if( !( fields >> i >> value ) || i >= val.size() ) return false;
+				val[i] = value;
+			}
+		}
+		xs.push_back( x );
+		zs.push_back( z );
+	}
+	return !in.bad();
+}
+
+// nested cuts of node i as in Separator::fractionalConnectionCuts(), with
+// the flow for the saturated arcs either recomputed or updated; returns
+// the sum of the flows (to compare both ways)
+static double nestedCuts( MinCut& mflow, const Digraph& digraph,
+                          const vector<double>& x, double z, u_int i,
+                          double eps, bool incremental )
+{
+	vector<double> capacity( x );
+	vector<int> cut( digraph.n_nodes );
+	vector<pair<int, double> > changes;
+	double sum = 0;
+	mflow.update( 0, i, &capacity[0] );
+	for( u_int nested = 0; nested < max_nested; nested++ ) {
+		if( nested > 0 && incremental ) {
+			mflow.update( changes );
+		}
+		else if( nested > 0 ) {
+			mflow.update( 0, i, &capacity[0] );
+		}
+		changes.clear();
+		double flow = mflow.min_cut( z - eps, &cut[0] );
+		sum += flow;
+		if( flow >= z - eps ) break;
+		for( u_int j = 0; j < digraph.n_arcs; j++ ) {
+			if( cut[digraph.arcs[j].v1] == 1 && cut[digraph.arcs[j].v2] != 1 &&
+			    capacity[j] < 1 ) {
+				capacity[j] = 1;
+				changes.push_back( pair<int, double>( j, 1 ) );
+			}
+		}
+	}
+	return sum;
+}
+
+// replay the points with the algorithm <engine>, one CSV line; the flows
+// and cuts are compared to those in <flows> and <cuts> (the recomputed
+// ones of the first engine, stored if empty)
+static void replay( const string& file, const string& engine,
+                    const Digraph& digraph, const vector<vector<double> >& xs,
+                    const vector<vector<double> >& zs,
+                    const vector<u_int>& targets, vector<double>& flows,
+                    vector<vector<int> >& cuts, double eps )
+{
+	bool reference = flows.empty();
+	// one instance for each target (updated), one for all (recomputed)
+	MinCut* mflow = MinCut::create( engine, digraph );
+	vector<MinCut*> updated;
+	for( u_int t = 0; t < targets.size(); t++ ) {
+		updated.push_back( MinCut::create( engine, digraph ) );
+		updated[t]->update( 0, targets[t], &xs[0][0] );
+	}
+	vector<int> cut( digraph.n_nodes ), cut2( digraph.n_nodes );
+	double t_full = 0, t_incremental = 0, t_nested = 0, t_nested2 = 0;
+	unsigned long changed = 0, different = 0;
+	bool consistent = true;
+	for( u_int p = 0; p < xs.size(); p++ ) {
+		vector<pair<int, double> > changes;
+		for( u_int j = 0; p > 0 && j < digraph.n_arcs; j++ ) {
+			if( xs[p][j] != xs[p - 1][j] ) {
+				changes.push_back( pair<int, double>( j, xs[p][j] ) );
+			}
+		}
+		changed += changes.size();
+		for( u_int t = 0; t < targets.size(); t++ ) {
+			double t0 = Tools::wallTime();
+			mflow->update( 0, targets[t], &xs[p][0] );
+			double f1 = mflow->min_cut( 1e9, &cut[0] );
+			double t1 = Tools::wallTime();
+			if( p > 0 ) updated[t]->update( changes );
+			double f2 = updated[t]->min_cut( 1e9, &cut2[0] );
+			double t2 = Tools::wallTime();
+			t_full += t1 - t0;
+			t_incremental += t2 - t1;
+			if( reference ) {
+				flows.push_back( f1 );
+				cuts.push_back( cut );
+			}
+			// equal flows, a cut may differ at a residual capacity which
+			// is a rounding error
+			u_int r = p * targets.size() + t;
+			if( fabs( f1 - flows[r] ) > 1e-9 || fabs( f2 - flows[r] ) > 1e-9 ) {
+				consistent = false;
+			}
+			if( cut != cuts[r] ) different++;
+			if( cut2 != cuts[r] ) different++;
+
+			u_int v = targets[t];
+			if( zs[p][v] <= eps ) continue;
+			t0 = Tools::wallTime();
+			f1 = nestedCuts( *mflow, digraph, xs[p], zs[p][v], v, eps, false );
+			t1 = Tools::wallTime();
+			f2 = nestedCuts( *mflow, digraph, xs[p], zs[p][v], v, eps, true );
+			t2 = Tools::wallTime();
+			t_nested += t1 - t0;
+			t_nested2 += t2 - t1;
+			if( fabs( f1 - f2 ) > 1e-9 ) consistent = false;
+		}
+	}
+	delete mflow;
+	for( u_int t = 0; t < updated.size(); t++ ) {
+		delete updated[t];
+	}
+	cout << file << "," << engine << "," << xs.size() << "," << targets.size()
+	     << "," << (double) changed / xs.size() << "," << t_full << ","
+	     << t_incremental << "," << t_nested << "," << t_nested2 << ","
+	     << different << "," << ( consistent ? "yes" : "NO" ) << endl;
+}
+
+int main( int argc, char *argv[] )
+{
+	u_int count = 10;
+	const double eps = 1e-6;
+	int i = 1;
+	for( ; i < argc && argv[i][0] == '-'; i++ ) {
+		string opt( argv[i] );
+		if( opt == "-t" && i + 1 < argc ) {
+			count = atoi( argv[++i] );
+		}
+	}
+	if( argc - i < 2 ) {
+		cout << "USAGE:\t" << argv[0] << " [-t targets] instance points...\n";
+		cout << "\t(points recorded by kmst -m dcc -F -R <points>)\n";
+		return 1;
+	}
+	string instance( argv[i++] );
+	Digraph digraph( instance, true );
+	cout << "points file,engine,points,targets,changed arcs (avg),full (s),"
+	     << "incremental (s),nested full (s),nested incremental (s),"
+	     << "different cuts,consistent\n";
+	for( ; i < argc; i++ ) {
+		string file( argv[i] );
+		vector<vector<double> > xs, zs;
+		if( !readPoints( file, digraph, xs, zs ) ) {
+			cerr << "Invalid points file " << file << endl;
+			return 1;
+		}
+		if( xs.empty() ) continue;
+
+		// the targets: the nodes with the largest sum of z
+		vector<pair<double, u_int> > order;
+		for( u_int v = 1; v < digraph.n_nodes; v++ ) {
+			double sum = 0;
+			for( u_int p = 0; p < zs.size(); p++ ) sum += zs[p][v];
+			if( sum > 0 ) order.push_back( pair<double, u_int>( -sum, v ) );
+		}
+		sort( order.begin(), order.end() );
+		vector<u_int> targets;
+		for( u_int t = 0; t < order.size() && t < count; t++ ) {
+			targets.push_back( order[t].second );
+		}
+
+		vector<double> flows;
+		vector<vector<int> > cuts;
+		replay( file, "pr", digraph, xs, zs, targets, flows, cuts, eps );
+		replay( file, "bk", digraph, xs, zs, targets, flows, cuts, eps );
+	}
+	return 0;
+}
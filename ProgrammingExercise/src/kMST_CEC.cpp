@@ -1,8 +1,9 @@
 #include "kMST_CEC.h"
 
 kMST_CEC::kMST_CEC( Digraph& _digraph, int _k, bool _quiet,
-                    bool _cut_early, int _max_cuts ) :
-  kMST_ILP( _digraph, "cec", _k, _quiet, _cut_early, _max_cuts )
+                    bool _cut_early, int _max_cuts, bool _gsec ) :
+  kMST_ILP( _digraph, _gsec ? "gsec" : "cec", _k, _quiet, _cut_early,
+            _max_cuts )
 {
 }
 
@@ -28,74 +29,72 @@ void kMST_CEC::createModel()
   //   (5): sum z(j) = k + 1
   //   (6): sum y(0,i) = 1
   //   ... all other constraints are added dynamically in callbacks ...
+  //   (cycle elimination cuts, or generalized subtour elimination cuts
+  //   x(E(S)) <= z(S) - z(j) for model "gsec")
   // Target function:
   //   min( sum of w[i]*x[i] )
   x = IloBoolVarArray( env, m );
   IloBoolVarArray y = IloBoolVarArray( env, a );
   z = IloBoolVarArray( env, n );
-  for ( u_int j = 0; j < n; j++ ) {
-    // add variables for nodes
-    char varname[16];
-    sprintf( varname, "z(%d)", j );
-    z[j] = IloBoolVar( env, varname );
+  // column indices of the variables in <rows>
+  int zc = addColumns( z, n );
+  int xc = addColumns( x, m );
+  int yc = addColumns( y, a );
+  if ( names ) {
+    for ( u_int j = 0; j < n; j++ ) {
+      z[j].setName( Tools::indicesToString( "z", j ).c_str() );
+    }
+    for ( u_int i = 0; i < m; i++ ) {
+      x[i].setName( Tools::indicesToString( "x", digraph.edges[i].v1,
+                                            digraph.edges[i].v2 ).c_str() );
+    }
+    for ( u_int i = 0; i < a; i++ ) {
+      y[i].setName( Tools::indicesToString( "y", digraph.arcs[i].v1,
+                                            digraph.arcs[i].v2 ).c_str() );
+    }
   }
   for ( u_int i = 0; i < m; i++ ) {
-    // add variables for edges
-    char varname[16];
-    sprintf( varname, "x(%d,%d)", digraph.edges[i].v1, digraph.edges[i].v2 );
-    x[i] = IloBoolVar( env, varname );
     // add constraint (1) and (2)
-    model.add( x[i] <= z[digraph.edges[i].v1] );
-    model.add( x[i] <= z[digraph.edges[i].v2] );
-  }
-  for ( u_int i = 0; i < a; i++ ) {
-    // add variable for arcs
-    char varname[16];
-    sprintf( varname, "y(%d,%d)", digraph.arcs[i].v1, digraph.arcs[i].v2 );
-    y[i] = IloBoolVar( env, varname );
+    rows.addRow( 'L', 0 );
+    rows.addTerm( xc + i, 1 );
+    rows.addTerm( zc + digraph.edges[i].v1, -1 );
+    rows.addRow( 'L', 0 );
+    rows.addTerm( xc + i, 1 );
+    rows.addTerm( zc + digraph.edges[i].v2, -1 );
   }
   for ( u_int i = 0; i < a; i++ ) {
     int e = digraph.arcs[i].e;
     int o = digraph.arcs[i].o;
-    // constraint 3
-    if ( o >= 0 ) {
-      model.add( y[i] + y[o] == x[e] );
+    // constraint 3, once for both arcs of an edge
+    if ( o >= 0 && o < (int) i ) {
+      continue;
     }
-    else {
-      model.add( y[i] == x[e] );
+    rows.addRow( 'E', 0 );
+    rows.addTerm( yc + i, 1 );
+    if ( o >= 0 ) {
+      rows.addTerm( yc + o, 1 );
     }
+    rows.addTerm( xc + e, -1 );
   }
   // Constraint 4
-  IloExpr constraint4 ( env );
+  addKRow( 'E', 1, 0 );
   for ( u_int i = 0; i < m; i++ ) {
-    constraint4 += x[i];
+    rows.addTerm( xc + i, 1 );
   }
-  model.add( constraint4 == k);
-  constraint4.end();
   // Constraint 5
-  IloExpr constraint5 ( env );
+  addKRow( 'E', 1, 1 );
   for ( u_int j = 0; j < n; j++ ) {
-    constraint5 += z[j];
+    rows.addTerm( zc + j, 1 );
   }
-  model.add( constraint5 == k+1 );
-  constraint5.end();
   // Constraint 6
-  IloNumExpr constraint6 ( env );
-  for ( u_int i = 0; i < a; i++ ) {
-    if ( digraph.arcs[i].v1 == 0 ) {
-      constraint6 += y[i];
-    }
+  rows.addRow( 'E', 1 );
+  for ( u_int i = digraph.outStart[0]; i < digraph.outStart[1]; i++ ) {
+    rows.addTerm( yc + digraph.outArc[i], 1 );
   }
-  model.add( constraint6 == 1 );
-  constraint6.end();
   // Objective function
-  IloExpr objective ( env );
-  for ( u_int i = 0; i < m; i ++ ) {
-    objective += digraph.edges[i].weight * x[i];
-  }
-  model.add( IloMinimize( env, objective ) );
+  addEdgeObjective( x );
   // give it a name for output
-  model.setName("k-MST (CEC)");
+  model.setName( model_type == "gsec" ? "k-MST (GSEC)" : "k-MST (CEC)" );
 }
 
 void kMST_CEC::outputVars()
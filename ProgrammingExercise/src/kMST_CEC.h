@@ -12,8 +12,10 @@ protected:
   void outputVars();
 
 public:
+  // with <_gsec> set, generalized subtour elimination cuts are separated
+  // instead of cycle elimination cuts (model "gsec")
   kMST_CEC( Digraph& _digraph, int _k, bool _quiet, bool _cut_early,
-            int _max_cuts );
+            int _max_cuts, bool _gsec = false );
 
 };
 
@@ -33,67 +33,63 @@ void kMST_DCC::createModel()
   x = IloBoolVarArray( env, a );
   IloBoolVarArray x0 = IloBoolVarArray( env, m );
   z = IloBoolVarArray( env, n );
-  for ( u_int j = 0; j < n; j++ ) {
-    // add variables for nodes
-    char varname[16];
-    sprintf( varname, "z(%d)", j );
-    z[j] = IloBoolVar( env, varname );
+  // column indices of the variables in <rows>
+  int zc = addColumns( z, n );
+  int x0c = addColumns( x0, m );
+  int xc = addColumns( x, a );
+  if ( names ) {
+    for ( u_int j = 0; j < n; j++ ) {
+      z[j].setName( Tools::indicesToString( "z", j ).c_str() );
+    }
+    for ( u_int i = 0; i < m; i++ ) {
+      x0[i].setName( Tools::indicesToString( "x0", digraph.edges[i].v1,
+                                             digraph.edges[i].v2 ).c_str() );
+    }
+    for ( u_int i = 0; i < a; i++ ) {
+      x[i].setName( Tools::indicesToString( "x", digraph.arcs[i].v1,
+                                            digraph.arcs[i].v2 ).c_str() );
+    }
   }
   for ( u_int i = 0; i < m; i++ ) {
-    // add variables for edges
-    char varname[16];
-    sprintf( varname, "x0(%d,%d)", digraph.edges[i].v1, digraph.edges[i].v2 );
-    x0[i] = IloBoolVar( env, varname );
     // add constraint (1) and (2)
-    model.add( x0[i] <= z[digraph.edges[i].v1] );
-    model.add( x0[i] <= z[digraph.edges[i].v2] );
-  }
-  for ( u_int i = 0; i < a; i++ ) {
-    // add variable for arcs
-    char varname[16];
-    sprintf( varname, "x(%d,%d)", digraph.arcs[i].v1, digraph.arcs[i].v2 );
-    x[i] = IloBoolVar( env, varname );
+    rows.addRow( 'L', 0 );
+    rows.addTerm( x0c + i, 1 );
+    rows.addTerm( zc + digraph.edges[i].v1, -1 );
+    rows.addRow( 'L', 0 );
+    rows.addTerm( x0c + i, 1 );
+    rows.addTerm( zc + digraph.edges[i].v2, -1 );
   }
   for ( u_int i = 0; i < a; i++ ) {
     int e = digraph.arcs[i].e;
     int o = digraph.arcs[i].o;
-    // constraint 3
-    if ( o >= 0 ) {
-      model.add( x[i] + x[o] == x0[e] );
+    // constraint 3, once for both arcs of an edge
+    if ( o >= 0 && o < (int) i ) {
+      continue;
     }
-    else {
-      model.add( x[i] == x0[e] );
+    rows.addRow( 'E', 0 );
+    rows.addTerm( xc + i, 1 );
+    if ( o >= 0 ) {
+      rows.addTerm( xc + o, 1 );
     }
+    rows.addTerm( x0c + e, -1 );
   }
   // Constraint 4
-  IloExpr constraint4 ( env );
+  addKRow( 'E', 1, 0 );
   for ( u_int i = 0; i < a; i++ ) {
-    constraint4 += x[i];
+    rows.addTerm( xc + i, 1 );
   }
-  model.add( constraint4 == k);
-  constraint4.end();
   // Constraint 5
-  IloExpr constraint5 ( env );
+  addKRow( 'E', 1, 1 );
   for ( u_int j = 0; j < n; j++ ) {
-    constraint5 += z[j];
+    rows.addTerm( zc + j, 1 );
   }
-  model.add( constraint5 == k+1 );
-  constraint5.end();
   // Constraint 6
-  IloNumExpr constraint6 ( env );
-  for ( u_int i = 0; i < a; i++ ) {
-    if ( digraph.arcs[i].v1 == 0 ) {
-      constraint6 += x[i];
-    }
+  rows.addRow( 'E', 1 );
+  for ( u_int i = digraph.outStart[0]; i < digraph.outStart[1]; i++ ) {
+    rows.addTerm( xc + digraph.outArc[i], 1 );
   }
-  model.add( constraint6 == 1 );
-  constraint6.end();
   // Objective function
-  IloExpr objective ( env );
-  for ( u_int i = 0; i < m; i ++ ) {
-    objective += digraph.edges[i].weight * x0[i];
-  }
-  model.add( IloMinimize( env, objective ) );
+  addEdgeObjective( x0 );
   // give it a name for output
   model.setName("k-MST (DCC)");
 }
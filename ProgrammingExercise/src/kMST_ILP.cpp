@@ -4,7 +4,11 @@ kMST_ILP::kMST_ILP( Digraph& _digraph, string _model_type, int _k,
                     bool _quiet, bool _cut_early, u_int _max_cuts ) :
     digraph( _digraph ), model_type( _model_type ), k( _k ),
     quiet( _quiet ), cut_early( _cut_early ),
-    max_cuts( _max_cuts ), epInt( 0.0 ), epOpt( 0.0 )
+    max_cuts( _max_cuts ), fractional_cuts( false ), sweep_cuts( false ),
+    names( false ), workers( 1 ), threads( 1 ),
+    opportunistic( false ), legacy( false ), callback( NULL ), generic( NULL ),
+    pool( NULL ), recorder( NULL ), engine( "pr" ), seed( 1 ), tail_threshold( 0 ), tail_rounds( 0 ),
+    haveTree( false ), epInt( 0.0 ), epOpt( 0.0 )
 {
     n = digraph.n_nodes;
     m = digraph.n_edges;
@@ -12,31 +16,125 @@ kMST_ILP::kMST_ILP( Digraph& _digraph, string _model_type, int _k,
     if( k == 0 ) k = n;
 }
 
+void kMST_ILP::setExport( string file )
+{
+    export_file = file;
+}
+
+void kMST_ILP::setWorkers( u_int _workers )
+{
+    workers = _workers > 0 ? _workers : 1;
+}
+
+void kMST_ILP::setThreads( u_int _threads, bool _opportunistic )
+{
+    threads = _threads > 0 ? _threads : 1;
+    opportunistic = _opportunistic;
+}
+
+void kMST_ILP::setLegacy( bool _legacy )
+{
+    legacy = _legacy;
+}
+
+void kMST_ILP::setFractionalCuts( bool _fractional_cuts )
+{
+    fractional_cuts = _fractional_cuts;
+}
+
+void kMST_ILP::setSweepCuts( bool _sweep_cuts )
+{
+    sweep_cuts = _sweep_cuts;
+}
+
+void kMST_ILP::setCutPool( u_int max_age )
+{
+    delete pool;
+    pool = max_age > 0 ? new CutPool( max_age ) : NULL;
+}
+
+void kMST_ILP::setRecord( string file )
+{
+    delete recorder;
+    recorder = NULL;
+    if ( !file.empty() ) {
+        recorder = new SeparationRecorder( file );
+        if ( !recorder->out ) {
+            cerr << "Cannot write the separated points to " << file << endl;
+            exit( -1 );
+        }
+    }
+}
+
+void kMST_ILP::setEngine( string _engine )
+{
+    engine = _engine;
+}
+
+void kMST_ILP::setSeed( unsigned int _seed )
+{
+    seed = _seed;
+}
+
+void kMST_ILP::setTailingOff( double threshold, u_int rounds )
+{
+    tail_threshold = threshold;
+    tail_rounds = rounds;
+}
+
 void kMST_ILP::solve( bool verbose )
 {
+    sweep( k, k, 1, verbose );
+}
+
+void kMST_ILP::sweep( int from, int to, int step, bool verbose )
+{
+    // a single solve keeps its usual output
+    bool csv = ( from != to );
+    k = from;
+
     // initialize CPLEX solver
     initCPLEX();
 
     try {
         // build model (calling model-specific implementation)
+        double buildTime = Tools::wallTime();
+        names = verbose || !export_file.empty();
         createModel();
+        ranges = rows.extract( env, model, cols );
+        rows.clear();
+        buildTime = Tools::wallTime() - buildTime;
 
+        double extractTime = Tools::wallTime();
         cplex = IloCplex( model );
+        extractTime = Tools::wallTime() - extractTime;
+        if ( !quiet ) {
+            cout << "Model build time: " << buildTime << "\n";
+            cout << "Model extraction time: " << extractTime << "\n";
+            cout << "Peak memory after build (MB): " << Tools::peakMemory()
+                 << "\n";
+        }
         if ( quiet ) {
             cplex.setOut( env.getNullStream() );
         }
-        cplex.exportModel( "model.lp" );
+        if ( !export_file.empty() ) {
+            cplex.exportModel( export_file.c_str() );
+        }
 
         // set parameters
         epInt = cplex.getParam( IloCplex::EpInt );
         epOpt = cplex.getParam( IloCplex::EpOpt );
-        // only use a single thread
-        cplex.setParam( IloCplex::Threads, 1 );
+        // the callbacks are cloned for each thread
+        cplex.setParam( IloCplex::Threads, threads );
+        cplex.setParam( IloCplex::ParallelMode, opportunistic ?
+                        IloCplex::Opportunistic : IloCplex::Deterministic );
 
-        // set cut- and lazy-constraint-callback for
-        // cycle-elimination cuts ("cec") or directed connection cuts ("dcc")
-        if (model_type == "cec" || model_type == "dcc") {
-            CutCallback* ccb = new CutCallback(
+        // set callback for cycle-elimination cuts ("cec"), generalized
+        // subtour elimination cuts ("gsec") or directed connection cuts
+        // ("dcc")
+        if (model_type == "cec" || model_type == "gsec" ||
+            model_type == "dcc") {
+            Separator separator(
                    env,
                    model_type,
                    epOpt,
@@ -45,40 +143,124 @@ void kMST_ILP::solve( bool verbose )
                    z,
                    k,
                    cut_early,
-                   max_cuts );
-            cplex.use( (UserCutI*) ccb );
-            cplex.use( (LazyConsI*) ccb );
+                   max_cuts,
+                   &separationStats );
+            separator.setFractional( fractional_cuts );
+            separator.setSweep( sweep_cuts );
+            separator.setPool( pool );
+            separator.setRecorder( recorder );
+            separator.setEngine( engine );
+            separator.setSeed( seed );
+            separator.setWorkers( workers );
+            separator.setTailingOff( tail_threshold, tail_rounds );
+            if ( legacy ) {
+                callback = new CutCallback( env, separator );
+                cplex.use( (UserCutI*) callback );
+                cplex.use( (LazyConsI*) callback );
+            }
+            else {
+                generic = new GenericCutCallback( separator, threads );
+                cplex.use( generic, generic->contexts() );
+            }
         }
 
-        // solve model
-        if ( !quiet ) {
-            cout << "Calling CPLEX solve ...\n";
-        }
-        cplex.solve();
-        if ( !quiet ) {
-            cout << "CPLEX finished.\n\n";
-            cout << "CPLEX status: " << cplex.getStatus() << "\n";
-            cout << "Branch-and-Bound nodes: " << cplex.getNnodes() << "\n";
-            if ( cplex.getStatus() != CPX_STAT_INFEASIBLE ) {
-                cout << "Objective value: " << cplex.getObjValue() << "\n";
-                if ( verbose ) {
-                    outputVars();
+        for ( ; step > 0 ? k <= to : k >= to; k += step ) {
+            if ( k != from ) {
+                // the cuts x(delta+(S)) >= 1 of dcc without fractional
+                // capacities need |S| <= k, so they are not valid for a
+                // smaller k
+                if ( pool != NULL && step < 0 ) {
+                    pool->clear();
+                }
+                setK( k );
+                if ( haveTree && resizeTree() ) {
+                    addTreeStart();
                 }
             }
-        }
-        double cpuTime = Tools::CPUtime();
-        if ( !quiet ) {
-            cout << "CPU time: " << cpuTime << "\n\n";
-        }
-        else {
-            cout << cpuTime << "," << cplex.getNnodes() << ",";
-            if ( cplex.getStatus() != CPX_STAT_INFEASIBLE ) {
-                cout << cplex.getObjValue() << endl;
+            double cpuStart = Tools::CPUtime();
+
+            // solve model
+            if ( !quiet ) {
+                if ( csv ) {
+                    cout << "k = " << k << "\n";
+                }
+                cout << "Calling CPLEX solve ...\n";
+            }
+            solveModel();
+            bool feasible = ( cplex.getStatus() == IloAlgorithm::Optimal ||
+                              cplex.getStatus() == IloAlgorithm::Feasible );
+            if ( !quiet ) {
+                cout << "CPLEX finished.\n\n";
+                cout << "CPLEX status: " << cplex.getStatus() << "\n";
+                cout << "Branch-and-Bound nodes: " << cplex.getNnodes() << "\n";
+                if ( callback != NULL || generic != NULL ) {
+                    cout << "Separation calls: " << separationStats.calls
+                         << ", cuts: " << separationStats.cuts
+                         << ", Maxflow builds: " << separationStats.maxflows
+                         << ", time: " << separationStats.time;
+                    if ( separationStats.calls > 0 ) {
+                        cout << " (" << separationStats.time /
+                                        separationStats.calls << " per call)";
+                    }
+                    cout << "\n";
+                    cout << "Skipped calls: " << separationStats.repeated
+                         << " (repeated point), " << separationStats.tailed
+                         << " (tailing off), skipped targets: "
+                         << separationStats.memoized << "\n";
+                    if ( pool != NULL ) {
+                        // estimate: each answered call saves the average
+                        // time of a separation, the checks cost pool->time
+                        unsigned long full = separationStats.calls -
+                                             pool->answered;
+                        double saved = full > 0 ? pool->answered *
+                            ( separationStats.time - pool->time ) / full : 0;
+                        cout << "Cut pool: " << pool->size() << " cuts"
+                             << ", added: " << pool->added
+                             << ", duplicates: " << pool->duplicates
+                             << ", aged out: " << pool->aged
+                             << ", calls answered: " << pool->answered
+                             << " of " << pool->checks
+                             << ", time: " << pool->time
+                             << ", time saved (estimated): "
+                             << saved - pool->time << "\n";
+                        pool->resetCounters();
+                    }
+                    separationStats.reset();
+                }
+                if ( cplex.getStatus() != CPX_STAT_INFEASIBLE ) {
+                    cout << "Objective value: " << cplex.getObjValue() << "\n";
+                    if ( verbose ) {
+                        outputVars();
+                    }
+                }
+            }
+            double cpuTime = Tools::CPUtime();
+            if ( csv ) {
+                cout << k << "," << cpuTime - cpuStart << ","
+                     << cplex.getNnodes() << ",";
+                cout << ( feasible ? cplex.getObjValue() : -1 ) << endl;
+            }
+            else if ( !quiet ) {
+                cout << "CPU time: " << cpuTime << "\n";
+                cout << "Peak memory (MB): " << Tools::peakMemory() << "\n\n";
             }
             else {
-                cout << -1 << endl;
+                cout << cpuTime << "," << cplex.getNnodes() << ",";
+                if ( cplex.getStatus() != CPX_STAT_INFEASIBLE ) {
+                    cout << cplex.getObjValue() << endl;
+                }
+                else {
+                    cout << -1 << endl;
+                }
+            }
+            haveTree = csv && feasible;
+            if ( haveTree ) {
+                saveTree();
             }
         }
+        if ( csv && !quiet ) {
+            cout << "Peak memory (MB): " << Tools::peakMemory() << "\n\n";
+        }
 
     }
     catch( IloException& e ) {
@@ -93,6 +275,183 @@ void kMST_ILP::solve( bool verbose )
 
 // ----- protected methods -----------------------------------------------
 
+void kMST_ILP::solveModel()
+{
+    cplex.solve();
+}
+
+void kMST_ILP::addEdgeObjective( IloBoolVarArray& _edgeVars )
+{
+    edgeVars = _edgeVars;
+    IloObjective objective = IloMinimize( env );
+    for ( u_int i = 0; i < m; i++ ) {
+        if ( digraph.edges[i].weight != 0 ) {
+            objective.setLinearCoef( edgeVars[i], digraph.edges[i].weight );
+        }
+    }
+    model.add( objective );
+}
+
+void kMST_ILP::addKRow( char sense, double scale, double offset )
+{
+    KEntry entry = { (int) rows.size(), -1, sense, scale, offset };
+    kEntries.push_back( entry );
+    rows.addRow( sense, scale * k + offset );
+}
+
+void kMST_ILP::addKTerm( int col, double scale, double offset )
+{
+    KEntry entry = { (int) rows.size() - 1, col, rows.sense.back(), scale,
+                     offset };
+    kEntries.push_back( entry );
+    rows.addTerm( col, scale * k + offset );
+}
+
+void kMST_ILP::addKBound( IloNumVarArray& vars )
+{
+    kBounds.push_back( vars );
+}
+
+void kMST_ILP::setK( int _k )
+{
+    k = _k;
+    for ( u_int i = 0; i < kEntries.size(); i++ ) {
+        const KEntry& entry = kEntries[i];
+        double value = entry.scale * k + entry.offset;
+        IloRange range = ranges[entry.row];
+        if ( entry.col >= 0 ) {
+            range.setLinearCoef( cols[entry.col], value );
+        }
+        else if ( entry.sense == 'E' ) {
+            range.setBounds( value, value );
+        }
+        else if ( entry.sense == 'G' ) {
+            range.setLB( value );
+        }
+        else {
+            range.setUB( value );
+        }
+    }
+    for ( u_int i = 0; i < kBounds.size(); i++ ) {
+        for ( IloInt j = 0; j < kBounds[i].getSize(); j++ ) {
+            kBounds[i][j].setUB( k );
+        }
+    }
+    if ( callback != NULL ) {
+        callback->setK( k );
+    }
+    if ( generic != NULL ) {
+        generic->setK( k );
+    }
+}
+
+void kMST_ILP::saveTree()
+{
+    IloNumArray xval( env, m );
+    IloNumArray zval( env, n );
+    cplex.getValues( xval, edgeVars );
+    cplex.getValues( zval, z );
+    treeEdges.assign( m, false );
+    treeNodes.assign( n, false );
+    for ( u_int i = 0; i < m; i++ ) {
+        treeEdges[i] = xval[i] > 0.5;
+    }
+    for ( u_int j = 0; j < n; j++ ) {
+        treeNodes[j] = zval[j] > 0.5;
+    }
+    xval.end();
+    zval.end();
+}
+
+bool kMST_ILP::resizeTree()
+{
+    // the tree has k edges and k+1 nodes including the root, which has
+    // exactly one edge; that edge is never changed
+    u_int size = 0;
+    vector<u_int> degree( n, 0 );
+    for ( u_int i = 0; i < m; i++ ) {
+        if ( treeEdges[i] ) {
+            size++;
+            degree[digraph.edges[i].v1]++;
+            degree[digraph.edges[i].v2]++;
+        }
+    }
+    // extend by the cheapest edge leaving the tree
+    while ( size < (u_int) k ) {
+        int best = -1;
+        for ( u_int v = 1; v < n; v++ ) {
+            if ( !treeNodes[v] ) {
+                continue;
+            }
+            for ( u_int j = digraph.adjStart[v]; j < digraph.adjStart[v+1]; j++ ) {
+                u_int u = digraph.adjNode[j];
+                u_int e = digraph.adjEdge[j];
+                if ( u != 0 && !treeNodes[u] && ( best < 0 ||
+                     digraph.edges[e].weight < digraph.edges[best].weight ) ) {
+                    best = e;
+                }
+            }
+        }
+        if ( best < 0 ) {
+            return false;
+        }
+        treeEdges[best] = true;
+        treeNodes[digraph.edges[best].v1] = true;
+        treeNodes[digraph.edges[best].v2] = true;
+        degree[digraph.edges[best].v1]++;
+        degree[digraph.edges[best].v2]++;
+        size++;
+    }
+    // prune the leaf with the heaviest edge (the node at the root edge is
+    // no leaf in this sense)
+    while ( size > (u_int) k ) {
+        int best = -1;
+        for ( u_int i = 0; i < m; i++ ) {
+            u_int v1 = digraph.edges[i].v1;
+            u_int v2 = digraph.edges[i].v2;
+            if ( !treeEdges[i] || v1 == 0 || v2 == 0 ||
+                 ( degree[v1] > 1 && degree[v2] > 1 ) ) {
+                continue;
+            }
+            if ( best < 0 || digraph.edges[i].weight > digraph.edges[best].weight ) {
+                best = i;
+            }
+        }
+        if ( best < 0 ) {
+            return false;
+        }
+        u_int v1 = digraph.edges[best].v1;
+        u_int v2 = digraph.edges[best].v2;
+        treeEdges[best] = false;
+        degree[v1]--;
+        degree[v2]--;
+        treeNodes[degree[v1] == 0 ? v1 : v2] = false;
+        size--;
+    }
+    return true;
+}
+
+void kMST_ILP::addTreeStart()
+{
+    IloNumVarArray vars( env );
+    IloNumArray vals( env );
+    for ( u_int i = 0; i < m; i++ ) {
+        vars.add( edgeVars[i] );
+        vals.add( treeEdges[i] ? 1 : 0 );
+    }
+    for ( u_int j = 0; j < n; j++ ) {
+        vars.add( z[j] );
+        vals.add( treeNodes[j] ? 1 : 0 );
+    }
+    // only the start for the current k
+    if ( cplex.getNMIPStarts() > 0 ) {
+        cplex.deleteMIPStarts( 0, cplex.getNMIPStarts() );
+    }
+    cplex.addMIPStart( vars, vals, IloCplex::MIPStartSolveMIP );
+    vars.end();
+    vals.end();
+}
+
 void kMST_ILP::initCPLEX()
 {
     if ( !quiet ) {
@@ -105,6 +464,7 @@ void kMST_ILP::initCPLEX()
         }
         model = IloModel( env );
         values = IloNumArray( env );
+        cols = IloNumVarArray( env );
     }
     catch( IloException& e ) {
         cerr << "kMST_ILP: exception " << e.getMessage();
@@ -121,6 +481,9 @@ kMST_ILP::~kMST_ILP()
 {
     // free CPLEX resources
     cplex.end();
+    delete generic;
+    delete pool;
+    delete recorder;
     model.end();
     env.end();
 }
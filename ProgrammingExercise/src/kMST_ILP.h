@@ -4,6 +4,8 @@
 #include "Tools.h"
 #include "Digraph.h"
 #include "CutCallback.h"
+#include "GenericCutCallback.h"
+#include "RowBuffer.h"
 #include <ilcplex/ilocplex.h>
 
 using namespace std;
@@ -23,6 +25,8 @@ protected:
     bool quiet;
     bool cut_early;
     u_int max_cuts;
+    bool fractional_cuts;
+    bool sweep_cuts;
 
     IloEnv env;
     IloModel model;
@@ -30,22 +34,137 @@ protected:
 
     IloBoolVarArray x; // edge or arc selection variables
     IloBoolVarArray z; // node selection variables
+    IloBoolVarArray edgeVars; // edge variables of the objective
 
     IloNumArray values; // to store result values of x
 
+    // all variables of the model as columns, referred to by index in <rows>
+    IloNumVarArray cols;
+    // rows added by createModel(), extracted into <ranges> in one go
+    RowBuffer rows;
+    IloRangeArray ranges;
+
+    // set variable names (only needed for model export or verbose output)
+    bool names;
+    // file to export the model to (empty for no export)
+    string export_file;
+    // number of threads for building the model and within each separation
+    // callback
+    u_int workers;
+    // number of threads of CPLEX, and its parallel mode
+    u_int threads;
+    bool opportunistic;
+
+    // the parts of the model depending on k, with the value scale*k+offset;
+    // setK() changes them in the extracted model
+    struct KEntry
+    {
+        int row; // index in <ranges>
+        int col; // index in <cols>, -1 for the right-hand side
+        char sense; // sense of the row
+        double scale, offset;
+    };
+    vector<KEntry> kEntries;
+    // variables with the upper bound k
+    vector<IloNumVarArray> kBounds;
+
+    // separation callback of cec and dcc (NULL for the other models),
+    // either a legacy or a generic callback
+    bool legacy;
+    CutCallback* callback;
+    GenericCutCallback* generic;
+    SeparationStats separationStats;
+    // cuts found by the separators (NULL if not enabled)
+    CutPool* pool;
+    // fractional points of dcc written for replaying (NULL if not enabled)
+    SeparationRecorder* recorder;
+    // maximum flow algorithm of the separators
+    string engine;
+    // seed of the separators
+    unsigned int seed;
+    // tailing off of the user cut separation (see Separator)
+    double tail_threshold;
+    u_int tail_rounds;
+
+    // tree of the last solution (edges and nodes) for the MIP start of the
+    // next k in a sweep
+    vector<bool> treeEdges, treeNodes;
+    bool haveTree;
+
     double epInt, epOpt;
 
     void initCPLEX();
 
+    // append variables to <cols>, returns the column index of the first one
+    template <class VarArray>
+    int addColumns( VarArray& vars, u_int count )
+    {
+        int first = cols.getSize();
+        for ( u_int i = 0; i < count; i++ ) {
+            cols.add( vars[i] );
+        }
+        return first;
+    }
+
+    // add the objective: minimize the weight of the selected edges
+    void addEdgeObjective( IloBoolVarArray& _edgeVars );
+
+    // start a row of <rows> with the right-hand side scale*k+offset
+    void addKRow( char sense, double scale, double offset );
+    // add a term with the coefficient scale*k+offset to the last row
+    void addKTerm( int col, double scale, double offset );
+    // all variables of <vars> have the upper bound k
+    void addKBound( IloNumVarArray& vars );
+    // change k in the extracted model (and the callback)
+    void setK( int _k );
+
+    // store the edges and nodes of the current solution as tree
+    void saveTree();
+    // extend (cheapest edge first) or prune (heaviest leaf first) the tree
+    // to k edges; returns false if this is not possible
+    bool resizeTree();
+    // pass the tree as (partial) MIP start, CPLEX completes the other
+    // variables
+    void addTreeStart();
+
     virtual void createModel() = 0;
     virtual void outputVars() = 0;
+    // run CPLEX on the extracted model; models which add rows or columns
+    // between several solves override this
+    virtual void solveModel();
 
 public:
 
     kMST_ILP( Digraph& _digraph, string _model_type, int _k, bool _quiet,
               bool cut_early = 0, u_int max_cuts = 1 );
     virtual ~kMST_ILP();
+    void setExport( string file );
+    void setWorkers( u_int _workers );
+    // <_opportunistic> trades reproducible runs for less synchronization
+    void setThreads( u_int _threads, bool _opportunistic );
+    // use the legacy user cut and lazy constraint callbacks
+    void setLegacy( bool _legacy );
+    // dcc: separate with fractional capacities (see Separator)
+    void setFractionalCuts( bool _fractional_cuts );
+    // dcc with fractional cuts: one MinCutSweep instead of a Maxflow per node
+    void setSweepCuts( bool _sweep_cuts );
+    // cec, gsec, dcc: keep the cuts found in a pool, checked before each
+    // separation, which drops cuts not binding in <max_age> checks
+    // (0: no pool)
+    void setCutPool( u_int max_age );
+    // dcc: write the fractional points separated to <file> (empty: don't)
+    void setRecord( string file );
+    // gsec, dcc: maximum flow algorithm, "pr" or "bk" (see MinCut)
+    void setEngine( string _engine );
+    // cec, gsec, dcc: seed for the order of equally good candidates
+    void setSeed( unsigned int _seed );
+    // cec, gsec, dcc: stop separating the fractional points of a node after
+    // <rounds> calls with a relative improvement below <threshold>
+    void setTailingOff( double threshold, u_int rounds );
     void solve( bool verbose );
+    // solve for k = from, from+step, ... up to <to> on the same model,
+    // printing one CSV line "k,cpu time,nodes,objective value" per k
+    void sweep( int from, int to, int step, bool verbose );
 
 };
 
@@ -1,7 +1,9 @@
 #include "kMST_MCF.h"
+#include "WorkerPool.h"
 
-kMST_MCF::kMST_MCF( Digraph& _digraph, int _k, bool _quiet ) :
-  kMST_ILP( _digraph, "mcf", _k, _quiet )
+kMST_MCF::kMST_MCF( Digraph& _digraph, int _k, bool _quiet, bool _lazy ) :
+  kMST_ILP( _digraph, "mcf", _k, _quiet ), zc( 0 ), xc( 0 ), yc( 0 ), fc( 0 ),
+  lazy( _lazy )
 {
 }
 
@@ -35,134 +37,266 @@ void kMST_MCF::createModel()
   //   (10): sum x(0,i) = 1
   // Objective function:
   //   min( sum of w[i]*x[i] )
-  f = IloNumVarArray( env, a * (n-1) );
+  // In lazy mode the model starts without any commodity, i.e. without
+  // f and constraints 1, 6, 7 and 8; see solveModel()
   x = IloBoolVarArray( env, m );
-  IloBoolVarArray y = IloBoolVarArray( env, a );
+  y = IloBoolVarArray( env, a );
   z = IloBoolVarArray( env, n );
-  for ( u_int j = 0; j < n; j++ ) {
-    // add variables for nodes
-    char varname[16];
-    sprintf( varname, "z(%d)", j );
-    z[j] = IloBoolVar( env, varname );
-  }
-  for ( u_int i = 0; i < m; i++ ) {
-    // add variables for edges
-    char varname[16];
-    sprintf( varname, "x(%d,%d)", digraph.edges[i].v1, digraph.edges[i].v2 );
-    x[i] = IloBoolVar( env, varname );
+  // column indices of the variables in <rows>
+  zc = addColumns( z, n );
+  xc = addColumns( x, m );
+  yc = addColumns( y, a );
+  flowCol.assign( n, -1 );
+  if ( lazy ) {
+    f = IloNumVarArray( env );
   }
-  for ( u_int i = 0; i < a; i++ ) {
-    // add variables for arcs
-    char varname[16];
-    sprintf( varname, "y(%d,%d)", digraph.arcs[i].v1, digraph.arcs[i].v2 );
-    y[i] = IloBoolVar( env, varname );
+  else {
+    f = IloNumVarArray( env, a * (n-1), 0, 1 );
+    fc = addColumns( f, a * (n-1) );
     for ( u_int l = 1; l < n; l++ ) {
-      sprintf( varname, "f(%d)(%d,%d)", l, digraph.arcs[i].v1, digraph.arcs[i].v2 );
-      f[(l-1)*a+i] = IloNumVar( env, 0, 1, varname );
-      // add constraints (1)
-      model.add( f[(l-1)*a+i] <= y[i] );
+      flowCol[l] = fc + (l-1)*a;
+    }
+  }
+  if ( names ) {
+    for ( u_int j = 0; j < n; j++ ) {
+      z[j].setName( Tools::indicesToString( "z", j ).c_str() );
+    }
+    for ( u_int i = 0; i < m; i++ ) {
+      x[i].setName( Tools::indicesToString( "x", digraph.edges[i].v1,
+                                            digraph.edges[i].v2 ).c_str() );
+    }
+    for ( u_int i = 0; i < a; i++ ) {
+      y[i].setName( Tools::indicesToString( "y", digraph.arcs[i].v1,
+                                            digraph.arcs[i].v2 ).c_str() );
+      for ( u_int l = 1; l < n && !lazy; l++ ) {
+        f[(l-1)*a+i].setName( Tools::indicesToString( "f", l,
+                              digraph.arcs[i].v1, digraph.arcs[i].v2 ).c_str() );
+      }
     }
   }
   for ( u_int i = 0; i < a; i++ ) {
     int e = digraph.arcs[i].e;
     int o = digraph.arcs[i].o;
+    // (2), (3) and (4) only once for both arcs of an edge
+    if ( o >= 0 && o < (int) i ) {
+      continue;
+    }
     // constraint (2)
+    rows.addRow( 'E', 0 );
+    rows.addTerm( yc + i, 1 );
     if ( o >= 0 ) {
-      model.add( y[i] + y[o] == x[e] );
-    }
-    else {
-      model.add( y[i] == x[e] );
+      rows.addTerm( yc + o, 1 );
     }
+    rows.addTerm( xc + e, -1 );
     // add constraints (3) and (4)
-    model.add( x[e] <= z[digraph.arcs[i].v1] );
-    model.add( x[e] <= z[digraph.arcs[i].v2] );
+    rows.addRow( 'L', 0 );
+    rows.addTerm( xc + e, 1 );
+    rows.addTerm( zc + digraph.arcs[i].v1, -1 );
+    rows.addRow( 'L', 0 );
+    rows.addTerm( xc + e, 1 );
+    rows.addTerm( zc + digraph.arcs[i].v2, -1 );
   }
   // constraint5
   for ( u_int i = 1; i < n; i++ ) {
-    IloNumExpr constraint5 ( env );
-    int count = 0;
-    for ( u_int j = 0; j < a; j++ ) {
-      if ( digraph.arcs[j].v2 == i ) {
-        constraint5 += y[j];
-        count++;
-      }
+    if ( digraph.inStart[i] == digraph.inStart[i+1] ) {
+      // no arc enters i
+      continue;
     }
-    if ( count > 0 ) {
-      model.add( constraint5 == z[i] );
+    rows.addRow( 'E', 0 );
+    for ( u_int j = digraph.inStart[i]; j < digraph.inStart[i+1]; j++ ) {
+      rows.addTerm( yc + digraph.inArc[j], 1 );
     }
+    rows.addTerm( zc + i, -1 );
   }
-  // Constraint 6
-  // j ... the node we look at currently
-  // l ... the target node
-  for ( u_int j = 1; j < n; j++ ) {
-    for (u_int l = 1; l < n; l++ ) {
-      if ( j != l ) {
-        IloNumExpr constraint6( env );
-        for ( u_int i = 0; i < a; i++ ) {
-          if ( digraph.arcs[i].v1 == j ) {
-            constraint6 += f[(l-1)*a+i];
-          }
-          else if ( digraph.arcs[i].v2 == j ) {
-            constraint6 -= f[(l-1)*a+i];
-          }
-        }
-        model.add( constraint6 == 0 );
-        constraint6.end();
-      }
-    }
+  // Constraints 1, 6, 7 and 8 for each commodity
+  if ( lazy ) {
+    // added by solveModel()
   }
-  // Constraint 7
-  for ( u_int l = 1; l < n; l++ ) {
-    IloNumExpr constraint7( env );
-    for ( u_int i = 0; i < a; i++ ) {
-      // we look for arcs coming from 0
-      if ( digraph.arcs[i].v1 == 0 ) {
-        constraint7 += f[(l-1)*a+i];
-      }
+  else if ( workers <= 1 ) {
+    for ( u_int l = 1; l < n; l++ ) {
+      commodityRows( l, rows );
     }
-    model.add( constraint7 == z[l] );
-    constraint7.end();
   }
-  // Constraint 8
-  for ( u_int l = 1; l < n; l++ ) {
-    IloNumExpr constraint8( env );
-    for ( u_int i = 0; i < a; i++ ) {
-      if ( digraph.arcs[i].v1 == l ) {
-        constraint8 += f[(l-1)*a+i];
-      }
-      else if ( digraph.arcs[i].v2 == l ) {
-        constraint8 -= f[(l-1)*a+i];
+  else {
+    // the commodities only read the digraph, so their rows are generated
+    // in parallel into separate buffers; these are appended in order of l,
+    // which gives exactly the rows of the sequential loop.
+    // a few commodities per worker at a time bound the extra memory
+    WorkerPool pool( workers );
+    vector<RowBuffer> blocks( 4 * workers );
+    for ( u_int first = 1; first < n; first += blocks.size() ) {
+      u_int count = min( (u_int) blocks.size(), n - first );
+      pool.run( count, [&]( u_int, u_int i ) {
+        commodityRows( first + i, blocks[i] );
+      } );
+      for ( u_int i = 0; i < count; i++ ) {
+        rows.append( blocks[i] );
+        blocks[i].clear();
       }
     }
-    model.add( constraint8 == -z[l] );
-    constraint8.end();
   }
   // Constraint 9
-  IloNumExpr constraint9 ( env );
+  addKRow( 'E', 1, 0 );
   for ( u_int i = 0; i < a; i++ ) {
-    constraint9 += y[i];
+    rows.addTerm( yc + i, 1 );
   }
-  model.add( constraint9 == k);
-  constraint9.end();
   // Constraint 10
-  IloNumExpr constraint10 ( env );
+  rows.addRow( 'E', 1 );
+  for ( u_int i = digraph.outStart[0]; i < digraph.outStart[1]; i++ ) {
+    rows.addTerm( yc + digraph.outArc[i], 1 );
+  }
+  // Objective function
+  addEdgeObjective( x );
+  // give it a name for output
+  model.setName("k-MST (MCF)");
+}
+
+void kMST_MCF::commodityRows( u_int l, RowBuffer& buf )
+{
+  // first column of the flow variables of commodity l
+  int lc = flowCol[l];
+  // Constraint 1
   for ( u_int i = 0; i < a; i++ ) {
-    if ( digraph.arcs[i].v1 == 0 ) {
-      constraint10 += y[i];
+    buf.addRow( 'L', 0 );
+    buf.addTerm( lc + i, 1 );
+    buf.addTerm( yc + i, -1 );
+  }
+  // Constraint 6
+  // j ... the node we look at currently
+  for ( u_int j = 1; j < n; j++ ) {
+    if ( j == l ) {
+      continue;
+    }
+    buf.addRow( 'E', 0 );
+    for ( u_int i = digraph.outStart[j]; i < digraph.outStart[j+1]; i++ ) {
+      buf.addTerm( lc + digraph.outArc[i], 1 );
+    }
+    for ( u_int i = digraph.inStart[j]; i < digraph.inStart[j+1]; i++ ) {
+      buf.addTerm( lc + digraph.inArc[i], -1 );
     }
   }
-  model.add( constraint10 == 1 );
-  constraint10.end();
-  // Objective function
-  IloNumExpr objective ( env );
-  for ( u_int i = 0; i < m; i ++ ) {
-    if ( digraph.edges[i].weight != 0 ) {
-      objective += digraph.edges[i].weight * x[i];
+  // Constraint 7: the flow leaving 0
+  buf.addRow( 'E', 0 );
+  for ( u_int i = digraph.outStart[0]; i < digraph.outStart[1]; i++ ) {
+    buf.addTerm( lc + digraph.outArc[i], 1 );
+  }
+  buf.addTerm( zc + l, -1 );
+  // Constraint 8
+  buf.addRow( 'E', 0 );
+  for ( u_int i = digraph.outStart[l]; i < digraph.outStart[l+1]; i++ ) {
+    buf.addTerm( lc + digraph.outArc[i], 1 );
+  }
+  for ( u_int i = digraph.inStart[l]; i < digraph.inStart[l+1]; i++ ) {
+    buf.addTerm( lc + digraph.inArc[i], -1 );
+  }
+  buf.addTerm( zc + l, 1 );
+}
+
+void kMST_MCF::solveModel()
+{
+  if ( !lazy ) {
+    cplex.solve();
+    return;
+  }
+  // Commodity l can be routed (i.e. constraints 1, 6, 7 and 8 of l have a
+  // solution f^l) iff the maximum flow from 0 to l with the capacities y
+  // is at least z(l). So the commodities are added only when this check
+  // fails, first for the LP relaxation (which then has the bound of the
+  // full model) and then for the integer solutions.
+  Maxflow mflow( digraph );
+  u_int round = 0;
+  // LP phase
+  IloConversion relaxX( env, x, ILOFLOAT );
+  IloConversion relaxY( env, y, ILOFLOAT );
+  IloConversion relaxZ( env, z, ILOFLOAT );
+  model.add( relaxX );
+  model.add( relaxY );
+  model.add( relaxZ );
+  bool feasible;
+  while ( ( feasible = cplex.solve() ) &&
+          addViolatedCommodities( mflow ) > 0 ) {
+    round++;
+  }
+  if ( !quiet && feasible ) {
+    cout << "LP bound: " << cplex.getObjValue() << "\n";
+  }
+  model.remove( relaxX );
+  model.remove( relaxY );
+  model.remove( relaxZ );
+  relaxX.end();
+  relaxY.end();
+  relaxZ.end();
+  // MIP phase: an integer solution may still contain a cycle which is not
+  // connected to the root, then it is solved again with the commodities of
+  // the disconnected nodes
+  while ( cplex.solve() && addViolatedCommodities( mflow ) > 0 ) {
+    round++;
+  }
+  if ( !quiet ) {
+    u_int active = 0;
+    for ( u_int l = 1; l < n; l++ ) {
+      if ( flowCol[l] >= 0 ) active++;
     }
+    cout << "Commodity rounds: " << round << "\n";
+    cout << "Active commodities: " << active << " of " << n-1 << "\n";
   }
-  model.add( IloMinimize( env, objective ) );
-  // give it a name for output
-  model.setName("k-MST (MCF)");
+}
+
+void kMST_MCF::addCommodity( u_int l, RowBuffer& buf )
+{
+  IloNumVarArray fl( env, a, 0, 1 );
+  if ( names ) {
+    for ( u_int i = 0; i < a; i++ ) {
+      fl[i].setName( Tools::indicesToString( "f", l,
+                     digraph.arcs[i].v1, digraph.arcs[i].v2 ).c_str() );
+    }
+  }
+  flowCol[l] = addColumns( fl, a );
+  f.add( fl );
+  commodityRows( l, buf );
+}
+
+u_int kMST_MCF::addViolatedCommodities( Maxflow& mflow )
+{
+  IloNumArray yval( env, a );
+  IloNumArray zval( env, n );
+  cplex.getValues( yval, y );
+  cplex.getValues( zval, z );
+  vector<double> capacity( a );
+  for ( u_int i = 0; i < a; i++ ) {
+    capacity[i] = yval[i] > epOpt ? yval[i] : 0;
+  }
+  vector<int> cut( n );
+  bool initialized = false;
+  RowBuffer buf;
+  u_int added = 0;
+  for ( u_int l = 1; l < n; l++ ) {
+    if ( flowCol[l] >= 0 || zval[l] <= epOpt ) {
+      continue;
+    }
+    if ( initialized ) {
+      mflow.update( 0, l );
+    }
+    else {
+      mflow.update( 0, l, &capacity[0] );
+      initialized = true;
+    }
+    // a border of 0 only computes the flow value, not the cut
+    if ( mflow.min_cut( 0, &cut[0] ) < zval[l] - epOpt ) {
+      addCommodity( l, buf );
+      added++;
+    }
+  }
+  if ( added > 0 ) {
+    ranges.add( buf.extract( env, model, cols ) );
+  }
+  if ( !quiet ) {
+    cout << "Commodities added: " << added << " (objective "
+         << cplex.getObjValue() << ")\n";
+  }
+  yval.end();
+  zval.end();
+  return added;
 }
 
 void kMST_MCF::outputVars()
@@ -183,7 +317,10 @@ void kMST_MCF::outputVars()
   // Flow variables
   for ( u_int i = 0; i < a; i++ ) {
     for ( u_int j = 1; j < n; j++ ) {
-      int flow = cplex.getValue( f[m*(j-1)+i] );
+      if ( flowCol[j] < 0 ) {
+        continue;
+      }
+      int flow = cplex.getValue( cols[flowCol[j]+i] );
       if (flow > 0) {
         cout << "Flow (" << j << ") " << digraph.arcs[i].v1 <<
                 "->" << digraph.arcs[i].v2;
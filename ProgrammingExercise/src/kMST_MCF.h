@@ -2,18 +2,35 @@
 #define __KMST_MCF_H__
 
 #include "kMST_ILP.h"
+#include "Maxflow.h"
 
 class kMST_MCF : public kMST_ILP {
 
 protected:
   // MCF variables
   IloNumVarArray f; // flow variables
+  IloBoolVarArray y; // arc variables
+  // column indices of the first z, x, y and f variable
+  int zc, xc, yc, fc;
+  // add the commodities only when the solution violates them
+  bool lazy;
+  // column index of the first flow variable of commodity l
+  // (-1 if the commodity is not part of the model yet)
+  vector<int> flowCol;
 
   void createModel();
+  // add constraints 1, 6, 7 and 8 of commodity l to <buf>
+  void commodityRows( u_int l, RowBuffer& buf );
+  void solveModel();
+  // add the flow variables of commodity l and its rows to <buf>
+  void addCommodity( u_int l, RowBuffer& buf );
+  // add all missing commodities which cannot be routed in the current
+  // solution, returns the number of commodities added
+  u_int addViolatedCommodities( Maxflow& mflow );
   void outputVars();
   
 public:
-  kMST_MCF( Digraph& _digraph, int _k, bool _quiet );
+  kMST_MCF( Digraph& _digraph, int _k, bool _quiet, bool _lazy = false );
 
 };
 
@@ -36,85 +36,80 @@ void kMST_MTZ::createModel()
   y = IloBoolVarArray( env, a );
   x = IloBoolVarArray( env, m );
   z = IloBoolVarArray( env, n );
-  u = IloNumVarArray( env, n );
-  for ( u_int j = 0; j < n; j++ ) {
-    // add variables for nodes
-    char varname[16];
-    sprintf( varname, "z(%d)", j );
-    z[j] = IloBoolVar( env, varname );
-    sprintf( varname, "u(%d)", j );
-    u[j] = IloNumVar( env, 0, k, varname );
-  }
-  for ( u_int i = 0; i < m; i++ ) {
-    // add variables for edges
-    char varname[16];
-    sprintf( varname, "x(%d,%d)", digraph.edges[i].v1, digraph.edges[i].v2 );
-    x[i] = IloBoolVar( env, varname );
-  }
-  for ( u_int i = 0; i < a; i++ ) {
-    char varname[16];
-    sprintf( varname, "y(%d,%d)", digraph.arcs[i].v1, digraph.arcs[i].v2 );
-    y[i] = IloBoolVar( env, varname );
+  u = IloNumVarArray( env, n, 0, k );
+  addKBound( u );
+  // column indices of the variables in <rows>
+  int zc = addColumns( z, n );
+  int uc = addColumns( u, n );
+  int xc = addColumns( x, m );
+  int yc = addColumns( y, a );
+  if ( names ) {
+    for ( u_int j = 0; j < n; j++ ) {
+      z[j].setName( Tools::indicesToString( "z", j ).c_str() );
+      u[j].setName( Tools::indicesToString( "u", j ).c_str() );
+    }
+    for ( u_int i = 0; i < m; i++ ) {
+      x[i].setName( Tools::indicesToString( "x", digraph.edges[i].v1,
+                                            digraph.edges[i].v2 ).c_str() );
+    }
+    for ( u_int i = 0; i < a; i++ ) {
+      y[i].setName( Tools::indicesToString( "y", digraph.arcs[i].v1,
+                                            digraph.arcs[i].v2 ).c_str() );
+    }
   }
   for ( u_int i = 0; i < a; i++ ) {
     int o = digraph.arcs[i].o;
     int e = digraph.arcs[i].e;
-    // add constraint (1)
-    if ( o >= 0 ) {
-      model.add( y[i] + y[o] == x[e] );
-    }
-    else {
-      model.add( y[i] == x[e] );
+    // add constraint (1), once for both arcs of an edge
+    if ( o < 0 || (int) i < o ) {
+      rows.addRow( 'E', 0 );
+      rows.addTerm( yc + i, 1 );
+      if ( o >= 0 ) {
+        rows.addTerm( yc + o, 1 );
+      }
+      rows.addTerm( xc + e, -1 );
     }
-    // add constraint (2)
-    model.add( u[digraph.arcs[i].v2] >= u[digraph.arcs[i].v1] + 1 - (1 - y[i])*(k+1) );
+    // add constraint (2): u(j) - u(i) - (k+1)*y(i,j) >= -k
+    addKRow( 'G', -1, 0 );
+    rows.addTerm( uc + digraph.arcs[i].v2, 1 );
+    rows.addTerm( uc + digraph.arcs[i].v1, -1 );
+    addKTerm( yc + i, -1, -1 );
   }
   // constraints (3), (4) and (5)
   for ( u_int i = 0; i < n; i++ ) {
-    IloExpr constraint3 ( env );
-    for ( u_int j = 0; j < a; j++ ) {
-      int e = digraph.arcs[j].e;
-      if ( digraph.arcs[j].v1 == i ) {
-        model.add( x[e] <= z[i] );
-      }
-      if ( digraph.arcs[j].v2 == i ) {
-        model.add( x[e] <= z[i] );
-        constraint3 += y[j];
-      }
+    // (4) and (5) for every edge incident to i
+    for ( u_int j = digraph.adjStart[i]; j < digraph.adjStart[i+1]; j++ ) {
+      rows.addRow( 'L', 0 );
+      rows.addTerm( xc + digraph.adjEdge[j], 1 );
+      rows.addTerm( zc + i, -1 );
     }
-    model.add( constraint3 <= z[i] );
-    constraint3.end();
+    // (3) over the arcs entering i
+    rows.addRow( 'L', 0 );
+    for ( u_int j = digraph.inStart[i]; j < digraph.inStart[i+1]; j++ ) {
+      rows.addTerm( yc + digraph.inArc[j], 1 );
+    }
+    rows.addTerm( zc + i, -1 );
   }
   // Constraint 6
-  IloExpr constraint6 ( env );
+  addKRow( 'E', 1, 0 );
   for ( u_int i = 0; i < m; i++ ) {
-    constraint6 += x[i];
+    rows.addTerm( xc + i, 1 );
   }
-  model.add( constraint6 == k);
-  constraint6.end();
   // Constraint 7
-  IloExpr constraint7 ( env );
+  addKRow( 'E', 1, 1 );
   for ( u_int j = 0; j < n; j++ ) {
-    constraint7 += z[j];
+    rows.addTerm( zc + j, 1 );
   }
-  model.add( constraint7 == k+1 );
-  constraint7.end();
-  // Constraint 8
-  IloExpr constraint8 ( env );
-  for ( u_int i = 0; i < m; i++ ) {
-    if ( digraph.edges[i].v1 == 0 || digraph.edges[i].v2 == 0 ) {
-      constraint8 += x[i];
-    }
+  // Constraint 8 over the edges incident to the root
+  rows.addRow( 'E', 1 );
+  for ( u_int i = digraph.adjStart[0]; i < digraph.adjStart[1]; i++ ) {
+    rows.addTerm( xc + digraph.adjEdge[i], 1 );
   }
-  model.add( constraint8 == 1 );
-  constraint8.end();
-  model.add( u[0] == 0 );
+  // Constraint 9
+  rows.addRow( 'E', 0 );
+  rows.addTerm( uc + 0, 1 );
   // Objective function
-  IloExpr objective ( env );
-  for ( u_int i = 0; i < m; i ++ ) {
-    objective += digraph.edges[i].weight * x[i];
-  }
-  model.add( IloMinimize( env, objective ) );
+  addEdgeObjective( x );
   // give it a name for output
   model.setName("k-MST (MTZ)");
 }
@@ -33,98 +33,93 @@ void kMST_SCF::createModel()
   //   (9): sum y(0,i) = 1
   // Objective function:
   //   min( sum of w[i]*x[i] )
-  f = IloNumVarArray( env, a );
+  f = IloNumVarArray( env, a, 0, k );
+  addKBound( f );
   x = IloBoolVarArray( env, m );
   IloBoolVarArray y = IloBoolVarArray( env, a );
   z = IloBoolVarArray( env, n );
-  for ( u_int j = 0; j < n; j++ ) {
-    // add variables for nodes
-    char varname[16];
-    sprintf( varname, "z(%d)", j );
-    z[j] = IloBoolVar( env, varname );
-  }
-  for ( u_int i = 0; i < m; i++ ) {
-    // add variables for edges
-    char varname[16];
-    sprintf( varname, "x(%d,%d)", digraph.edges[i].v1, digraph.edges[i].v2 );
-    x[i] = IloBoolVar( env, varname );
-  }
-  for ( u_int i = 0; i < a; i++ ) {
-    // add variable for arcs
-    char varname[16];
-    sprintf( varname, "y(%d,%d)", digraph.arcs[i].v1, digraph.arcs[i].v2 );
-    y[i] = IloBoolVar( env, varname );
-    sprintf( varname, "f(%d,%d)", digraph.arcs[i].v1, digraph.arcs[i].v2 );
-    f[i] = IloNumVar( env, 0, k, varname );
+  // column indices of the variables in <rows>
+  int zc = addColumns( z, n );
+  int xc = addColumns( x, m );
+  int yc = addColumns( y, a );
+  int fc = addColumns( f, a );
+  if ( names ) {
+    for ( u_int j = 0; j < n; j++ ) {
+      z[j].setName( Tools::indicesToString( "z", j ).c_str() );
+    }
+    for ( u_int i = 0; i < m; i++ ) {
+      x[i].setName( Tools::indicesToString( "x", digraph.edges[i].v1,
+                                            digraph.edges[i].v2 ).c_str() );
+    }
+    for ( u_int i = 0; i < a; i++ ) {
+      y[i].setName( Tools::indicesToString( "y", digraph.arcs[i].v1,
+                                            digraph.arcs[i].v2 ).c_str() );
+      f[i].setName( Tools::indicesToString( "f", digraph.arcs[i].v1,
+                                            digraph.arcs[i].v2 ).c_str() );
+    }
   }
   for ( u_int i = 0; i < a; i++ ) {
     // add constraints (1) and (2)
     if ( digraph.arcs[i].v1 != 0 ) {
-      model.add( f[i] <= k*y[i] );
+      rows.addRow( 'L', 0 );
+      rows.addTerm( fc + i, 1 );
+      addKTerm( yc + i, -1, 0 );
     }
     int e = digraph.arcs[i].e;
     int o = digraph.arcs[i].o;
-    if ( o >= 0 ) {
-      model.add( y[i] + y[o] == x[e] );
+    // (2), (3) and (4) only once for both arcs of an edge
+    if ( o >= 0 && o < (int) i ) {
+      continue;
     }
-    else {
-      model.add( y[i] == x[e] );
+    rows.addRow( 'E', 0 );
+    rows.addTerm( yc + i, 1 );
+    if ( o >= 0 ) {
+      rows.addTerm( yc + o, 1 );
     }
+    rows.addTerm( xc + e, -1 );
     // add constraints (3) and (4)
-    model.add( x[e] <= z[digraph.arcs[i].v1] );
-    model.add( x[e] <= z[digraph.arcs[i].v2] );
+    rows.addRow( 'L', 0 );
+    rows.addTerm( xc + e, 1 );
+    rows.addTerm( zc + digraph.arcs[i].v1, -1 );
+    rows.addRow( 'L', 0 );
+    rows.addTerm( xc + e, 1 );
+    rows.addTerm( zc + digraph.arcs[i].v2, -1 );
   }
-  // Constraint 5
-  for ( u_int i = 0; i < a; i++ ) {
-    // we look for edges starting from 0
-    if ( digraph.arcs[i].v1 == 0 ) {
-      model.add( f[i] == k * y[i] );
-    }
+  // Constraint 5 for the arcs starting from 0
+  for ( u_int i = digraph.outStart[0]; i < digraph.outStart[1]; i++ ) {
+    rows.addRow( 'E', 0 );
+    rows.addTerm( fc + digraph.outArc[i], 1 );
+    addKTerm( yc + digraph.outArc[i], -1, 0 );
   }
   // Constraint 6
   // j ... the node we look at currently
   for ( u_int j = 1; j < n; j++ ) {
-    IloExpr constraint6( env );
-    for ( u_int i = 0; i < a; i++ ) {
-      if ( digraph.arcs[i].v1 == j ) {
-        constraint6 += f[i];
-      }
-      else if ( digraph.arcs[i].v2 == j ) {
-        constraint6 -= f[i];
-      }
+    rows.addRow( 'E', 0 );
+    for ( u_int i = digraph.outStart[j]; i < digraph.outStart[j+1]; i++ ) {
+      rows.addTerm( fc + digraph.outArc[i], 1 );
     }
-    model.add( constraint6 == -1*z[j] );
-    constraint6.end();
+    for ( u_int i = digraph.inStart[j]; i < digraph.inStart[j+1]; i++ ) {
+      rows.addTerm( fc + digraph.inArc[i], -1 );
+    }
+    rows.addTerm( zc + j, 1 );
   }
   // Constraint 7
-  IloNumExpr constraint7 ( env );
+  addKRow( 'E', 1, 0 );
   for ( u_int e = 0; e < m; e++ ) {
-    constraint7 += x[e];
+    rows.addTerm( xc + e, 1 );
   }
-  model.add( constraint7 == k);
-  constraint7.end();
   // Constraint 8
-  IloExpr constraint8 ( env );
+  addKRow( 'E', 1, 1 );
   for ( u_int j = 0; j < n; j++ ) {
-    constraint8 += z[j];
+    rows.addTerm( zc + j, 1 );
   }
-  model.add( constraint8 == k+1 );
-  constraint8.end();
   // Constraint 9
-  IloNumExpr constraint9 ( env );
-  for ( u_int i = 0; i < a; i++ ) {
-    if ( digraph.arcs[i].v1 == 0 ) {
-      constraint9 += y[i];
-    }
+  rows.addRow( 'E', 1 );
+  for ( u_int i = digraph.outStart[0]; i < digraph.outStart[1]; i++ ) {
+    rows.addTerm( yc + digraph.outArc[i], 1 );
   }
-  model.add( constraint9 == 1 );
-  constraint9.end();
   // Objective function
-  IloExpr objective ( env );
-  for ( u_int e = 0; e < m; e ++ ) {
-    objective += digraph.edges[e].weight * x[e];
-  }
-  model.add( IloMinimize( env, objective ) );
+  addEdgeObjective( x );
   // give it a name for output
   model.setName("k-MST (SCF)");
 }
@@ -1,13 +1,166 @@
 // test app for the maxflow algorithm as updated by stefan slaby 02/2008
 
 #include "Maxflow.h"
+#include "MinCut.h"
 
 #include <cstdlib>
+#include <cmath>
 #include <iostream>
 #include <list>
+#include <vector>
+#include <queue>
 
 using namespace std;
 
+// maximum flow by shortest augmenting paths on a dense residual matrix, as a
+// reference for the random tests
+static double reference( int n, const list<pair<u_int, u_int> >& arcs,
+                         const double *capacities, int s, int t )
+{
+	vector<vector<double> > res( n, vector<double>( n, 0 ) );
+	int i = 0;
+	for( list<pair<u_int, u_int> >::const_iterator it = arcs.begin();
+	     it != arcs.end(); ++it, i++ ) {
+		if( it->first != it->second ) res[it->first][it->second] += capacities[i];
+	}
+	double flow = 0;
+	while( true ) {
+		vector<int> pred( n, -1 );
+		pred[s] = s;
+		queue<int> Q;
+		Q.push( s );
+		while( !Q.empty() && pred[t] < 0 ) {
+			int v = Q.front();
+			Q.pop();
+			for( int w = 0; w < n; w++ ) {
+				if( pred[w] < 0 && res[v][w] > 1e-9 ) {
+					pred[w] = v;
+					Q.push( w );
+				}
+			}
+		}
+		if( pred[t] < 0 ) return flow;
+		double delta = 1e100;
+		for( int w = t; w != s; w = pred[w] ) delta = min( delta, res[pred[w]][w] );
+		for( int w = t; w != s; w = pred[w] ) {
+			res[pred[w]][w] -= delta;
+			res[w][pred[w]] += delta;
+		}
+		flow += delta;
+	}
+}
+
+// capacity <step> (0 ... 7) of the random tests: quarters for double,
+// multiples of 2^20 for int32_t (large, but the flows cannot overflow)
+template <class Cap> Cap capacity( int step );
+template <> double capacity<double>( int step ) { return step / 4.0; }
+template <> int32_t capacity<int32_t>( int step ) { return step << 20; }
+
+// random graphs (with loops, parallel and opposite arcs) and capacities
+// for the algorithm <engine> (see MinCutT::create()) with capacities of
+// type Cap: the flow must match the reference, and the arcs leaving the
+// source side of the cut must have this capacity; returns the number of
+// failures
+template <class Cap>
+static int random_tests( int count, const string& engine )
+{
+	int failures = 0;
+	srand( 1 );
+	for( int r = 0; r < count; r++ ) {
+		int n = 2 + rand() % 30;
+		int m = rand() % ( 4 * n + 1 );
+		list<pair<u_int, u_int> > arcs;
+		for( int i = 0; i < m; i++ ) {
+			arcs.push_back( pair<u_int, u_int>( rand() % n, rand() % n ) );
+		}
+		vector<pair<u_int, u_int> > span( arcs.begin(), arcs.end() );
+		MinCutT<Cap>* algorithm =
+			MinCutT<Cap>::create( engine, n, m, m > 0 ? &span[0] : NULL );
+		vector<Cap> capacities( m + 1 );
+		vector<int> cut( n );
+		for( int i = 0; i < m; i++ ) {
+			capacities[i] = rand() % 3 == 0 ? 0 : capacity<Cap>( rand() % 8 );
+		}
+		int s = 0, t = 1;
+		for( int q = 0; q < 6; q++ ) {
+			// the first run sets the capacities, the next two only s and t,
+			// the last ones change a few capacities and start from the flow
+			// of the run before
+			if( q < 3 ) {
+				s = rand() % n;
+				t = ( s + 1 + rand() % ( n - 1 ) ) % n;
+			}
+			if( q == 0 ) algorithm->update( s, t, &capacities[0] );
+			else if( q < 3 ) algorithm->update( s, t );
+			else {
+				vector<pair<int, Cap> > changes;
+				for( int c = rand() % 4; c >= 0 && m > 0; c-- ) {
+					int i = rand() % m;
+					capacities[i] = capacity<Cap>( rand() % 8 );
+					changes.push_back( pair<int, Cap>( i, capacities[i] ) );
+				}
+				algorithm->update( changes );
+			}
+			double f = algorithm->min_cut( CapTraits<Cap>::biggest(), &cut[0] );
+			vector<double> values( capacities.begin(), capacities.end() );
+			double expected = reference( n, arcs, &values[0], s, t );
+			double across = 0;
+			int i = 0;
+			for( list<pair<u_int, u_int> >::iterator it = arcs.begin();
+			     it != arcs.end(); ++it, i++ ) {
+				if( cut[it->first] == 1 && cut[it->second] != 1 ) across += capacities[i];
+			}
+			if( fabs( f - expected ) > 1e-6 || fabs( across - f ) > 1e-6 ||
+			    cut[s] != 1 || cut[t] != 2 ) {
+				cout << engine << " random test " << r << " (" << sizeof( Cap )
+				     << " byte capacities) failed: flow " << f
+				     << ", expected " << expected << ", cut " << across << endl;
+				failures++;
+			}
+		}
+		delete algorithm;
+	}
+	return failures;
+}
+
+// capacities in steps of 0.1, whose sums leave residual capacities which
+// are rounding errors (below CapTraits<double>::residual_eps()): both
+// algorithms must find the same cut; returns the number of failures
+static int rounding_tests( int count )
+{
+	int failures = 0;
+	srand( 1 );
+	for( int r = 0; r < count; r++ ) {
+		int n = 2 + rand() % 30;
+		int m = rand() % ( 4 * n + 1 );
+		vector<pair<u_int, u_int> > arcs;
+		for( int i = 0; i < m; i++ ) {
+			arcs.push_back( pair<u_int, u_int>( rand() % n, rand() % n ) );
+		}
+		vector<double> capacities( m + 1 );
+		for( int i = 0; i < m; i++ ) {
+			capacities[i] = rand() % 3 == 0 ? 0 : ( rand() % 10 ) * 0.1;
+		}
+		int s = rand() % n;
+		int t = ( s + 1 + rand() % ( n - 1 ) ) % n;
+		MinCut* pr = MinCut::create( "pr", n, m, m > 0 ? &arcs[0] : NULL );
+		MinCut* bk = MinCut::create( "bk", n, m, m > 0 ? &arcs[0] : NULL );
+		pr->update( s, t, &capacities[0] );
+		bk->update( s, t, &capacities[0] );
+		vector<int> cut_pr( n ), cut_bk( n );
+		double f_pr = pr->min_cut( 1e9, &cut_pr[0] );
+		double f_bk = bk->min_cut( 1e9, &cut_bk[0] );
+		if( fabs( f_pr - f_bk ) > 1e-6 || cut_pr != cut_bk ) {
+			cout << "rounding test " << r << " failed: flow " << f_pr
+			     << " (pr), " << f_bk << " (bk)" << endl;
+			failures++;
+		}
+		delete pr;
+		delete bk;
+	}
+	return failures;
+}
+
 int main()
 {
 	
@@ -78,5 +231,11 @@ int main()
 	}
 	delete[] cut;
 	
+	int failures = random_tests<double>( 1000, "pr" ) +
+	               random_tests<double>( 1000, "bk" ) +
+	               random_tests<int32_t>( 1000, "pr" ) +
+	               random_tests<int32_t>( 1000, "bk" ) +
+	               rounding_tests( 5000 );
+	cout << "random tests: " << failures << " failures" << endl;
+	return failures > 0 ? 1 : 0;
 }
-